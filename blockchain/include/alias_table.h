@@ -0,0 +1,41 @@
+#ifndef ALIAS_TABLE_H
+#define ALIAS_TABLE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <vector>
+#include "validator.h"
+
+// Vose's alias method: after an O(n) build, drawing validator i with
+// probability stake_i / totalStake takes one uniform column pick and one
+// biased coin flip, whatever the number of validators. Rebuild whenever
+// stakes change. Validators with stake <= 0 are never drawn.
+class AliasTable {
+private:
+    // Column i keeps itself with probability[i], otherwise yields alias[i]
+    std::vector<double> probability;
+    std::vector<uint32_t> alias;
+
+public:
+    AliasTable();
+    explicit AliasTable(const std::vector<Validator>& validators);
+    void build(const std::vector<Validator>& validators);
+    // True when no validator has positive stake
+    bool empty() const;
+    size_t size() const;
+
+    // Index into the validator vector the table was built from. Throws
+    // std::logic_error on an empty table.
+    template <typename URNG>
+    size_t sample(URNG& gen) const {
+        if (probability.empty()) throw std::logic_error("AliasTable: no validator with positive stake");
+        std::uniform_int_distribution<size_t> column(0, probability.size() - 1);
+        std::uniform_real_distribution<double> coin(0.0, 1.0);
+        size_t i = column(gen);
+        return coin(gen) < probability[i] ? i : alias[i];
+    }
+};
+
+#endif
\ No newline at end of file
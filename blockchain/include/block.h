@@ -2,14 +2,18 @@
 #define BLOCK_H
 
 #include <string>
+#include <cstdint>
+#include "hash256.h"
 
 class Block {
 public:
     virtual ~Block() = default;
-    virtual std::string getHash() const = 0;
-    virtual std::string getPreviousHash() const = 0;
+    virtual Hash256 getHash() const = 0;
+    virtual Hash256 getPreviousHash() const = 0;
     virtual int getIndex() const = 0;
-    virtual std::string calculateHash() const = 0;
+    // Creation time in milliseconds since the Unix epoch, fixed when the block is built
+    virtual int64_t getTimestamp() const = 0;
+    virtual Hash256 calculateHash() const = 0;
     virtual void display() const = 0;
 };
 
@@ -0,0 +1,59 @@
+#ifndef BLOCK_HEADER_H
+#define BLOCK_HEADER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "hash256.h"
+
+// Canonical hash input of every block, PoW and PoS alike. It serializes to a
+// fixed 160-byte little-endian layout:
+//
+//   offset   0  previousHash  32 bytes
+//   offset  32  merkleRoot    32 bytes
+//   offset  64  historyRoot   32 bytes (MerkleMountainRange root over the
+//                                       hashes of blocks 0..height-1)
+//   offset  96  stateRoot     32 bytes (PoS: stake state after the block;
+//                                       PoW: target schedule up to the block)
+//   offset 128  version       u32
+//   offset 132  height        u32
+//   offset 136  timestamp     i64 (milliseconds since the Unix epoch)
+//   offset 144  bits          u32 (compact PoW target, 0 for PoS)
+//   offset 148  extraNonce    u32
+//   offset 152  nonce         u64
+//
+// The first 128 bytes never change while mining, so miners compress them once
+// and only rehash the last 32 bytes (which hold the nonces) per attempt.
+// historyRoot lets a client holding only a header check ancestry proofs
+// (Blockchain::getAncestryProof) for every earlier block.
+//
+// A PoW block's hash is hash(). A PoS block is sealed by its proposer: its
+// hash is hashWithProposer(id), sha256 of the serialized header followed by
+// the proposer's id bytes, so the proposer cannot be swapped without
+// changing the hash.
+struct BlockHeader {
+    static const size_t SIZE = 160;
+    static const size_t MIDSTATE_SIZE = 128;
+    static const size_t EXTRA_NONCE_OFFSET = 148;
+    static const size_t NONCE_OFFSET = 152;
+    static const uint32_t CURRENT_VERSION = 1;
+
+    uint32_t version;
+    uint32_t height;
+    Hash256 previousHash;
+    Hash256 merkleRoot;
+    Hash256 historyRoot;
+    Hash256 stateRoot;
+    int64_t timestamp;
+    uint32_t bits;
+    uint32_t extraNonce;
+    uint64_t nonce;
+
+    BlockHeader();
+    void serialize(unsigned char out[SIZE]) const;
+    static BlockHeader deserialize(const unsigned char in[SIZE]);
+    Hash256 hash() const;
+    Hash256 hashWithProposer(const std::string& proposer) const;
+};
+
+#endif
\ No newline at end of file
@@ -2,26 +2,29 @@
 #define BLOCK_POS_H
 
 #include "block.h"
+#include "block_header.h"
 #include <string>
 
 class BlockPos : public Block {
 private:
-    int index;
-    std::string previousHash;
-    std::string hash;
-    std::string data;
+    BlockHeader header;
+    Hash256 hash;
     std::string validator;
 
 public:
-    BlockPos(int idx, const std::string& prevHash, const std::string& h, const std::string& d, const std::string& v);
+    BlockPos(const BlockHeader& hdr, const Hash256& h, const std::string& v);
     ~BlockPos() override;
-    std::string getHash() const override;
-    std::string getPreviousHash() const override;
+    Hash256 getHash() const override;
+    Hash256 getPreviousHash() const override;
     int getIndex() const override;
-    std::string calculateHash() const override;
+    int64_t getTimestamp() const override;
+    Hash256 calculateHash() const override;
     void display() const override;
-    std::string getData() const;
+    Hash256 getMerkleRoot() const;
     std::string getValidator() const;
+    const BlockHeader& getHeader() const;
+    // Stake state after this block (header.stateRoot, see BlockchainPos)
+    Hash256 getStateRoot() const;
 };
 
 #endif
\ No newline at end of file
@@ -2,28 +2,29 @@
 #define BLOCK_POW_H
 
 #include "block.h"
+#include "block_header.h"
 #include <string>
+#include <cstdint>
 
 class BlockPow : public Block {
 private:
-    int index;
-    std::string previousHash;
-    std::string hash;
-    std::string data;
-    int nonce;
-    int difficulty;
+    BlockHeader header;
+    Hash256 hash;
 
 public:
-    BlockPow(int idx, const std::string& prevHash, const std::string& h, const std::string& d, int n, int diff);
+    BlockPow(const BlockHeader& hdr, const Hash256& h);
     ~BlockPow() override;
-    std::string getHash() const override;
-    std::string getPreviousHash() const override;
+    Hash256 getHash() const override;
+    Hash256 getPreviousHash() const override;
     int getIndex() const override;
-    std::string calculateHash() const override;
+    int64_t getTimestamp() const override;
+    Hash256 calculateHash() const override;
     void display() const override;
-    std::string getData() const;
-    int getNonce() const;
-    int getDifficulty() const;
+    Hash256 getMerkleRoot() const;
+    uint64_t getNonce() const;
+    uint32_t getExtraNonce() const;
+    Hash256 getTarget() const;
+    const BlockHeader& getHeader() const;
 };
 
 #endif
\ No newline at end of file
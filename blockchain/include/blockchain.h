@@ -5,21 +5,34 @@
 #include <string>
 #include "block.h"
 #include "merkle_tree.h"
+#include "merkle_mountain_range.h"
 #include "validator.h"
 
 class Blockchain {
 protected:
     std::vector<Block*> chain;
     int difficulty;
+    // Commitment over every block hash in chain order; derived chains append
+    // to it whenever they append a block.
+    MerkleMountainRange history;
 
 public:
     Blockchain(int diff = 2);
     virtual ~Blockchain();
     virtual void addBlock(const std::vector<std::string>& transactions) = 0;
-    bool isChainValid() const;
+    virtual bool isChainValid() const;
     void displayChain() const;
     void setDifficulty(int diff);
-    virtual std::string getLatestHash() const;
+    virtual Hash256 getLatestHash() const;
+    // History commitment: the root commits to all block hashes so far. Each
+    // block's header carries the root as it was before that block, so a
+    // client holding only the header of block `tip` checks that block
+    // `height` < tip is its ancestor with getAncestryProof(height, tip)
+    // against header.historyRoot. The one-argument form proves against
+    // getHistoryRoot().
+    Hash256 getHistoryRoot() const;
+    MmrProof getAncestryProof(uint64_t height) const;
+    MmrProof getAncestryProof(uint64_t height, uint64_t tip) const;
 };
 
 #endif
\ No newline at end of file
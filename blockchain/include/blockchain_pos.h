@@ -5,23 +5,70 @@
 #include "block_pos.h"
 #include "merkle_tree.h"
 #include "validator.h"
+#include "sparse_merkle_tree.h"
+#include "stake_index.h"
+#include "proposer_schedule.h"
 #include <vector>
 #include <string>
 
 class BlockchainPos : public Blockchain {
 private:
     std::vector<BlockPos*> chain;
-    std::vector<Validator> validators;
+    // Current stakes; proposers are sampled from it in O(log n)
+    StakeIndex stakes;
+    // Stake of every validator, keyed by id; its root is sealed into each block
+    SparseMerkleTree stakeState;
+    // One stake snapshot per epoch, taken when the epoch's boundary block
+    // (the one before it, or genesis for epoch 0) is added; it is committed
+    // by that block's state root. Schedules are built from them when the
+    // epoch's first block is added and kept for O(1) proposer lookups, but
+    // isChainValid rebuilds them from the snapshots and block hashes.
+    size_t epochLength;
+    std::vector<StakeSnapshot> epochStakes;
+    std::vector<ProposerSchedule> schedules;
+
+    void commitStakes(const std::vector<Hash256>& previous);
+    void commitStake(const std::string& validatorId);
+    const ProposerSchedule& scheduleFor(uint64_t slot);
+    void recordBoundary(uint64_t height);
+    BlockHeader makeHeader(const Hash256& merkleRoot) const;
 
 public:
-    BlockchainPos(int diff = 2, const std::vector<Validator>& vals = {});
+    BlockchainPos(int diff = 2, const std::vector<Validator>& vals = {}, size_t epochLen = ProposerSchedule::DEFAULT_EPOCH_LENGTH);
     ~BlockchainPos() override;
     void addBlock(const std::vector<std::string>& transactions) override;
-    bool isChainValid() const ;
+    bool isChainValid() const override;
     void displayChain() const ;
     void setDifficulty(int diff) ;
-    std::string getLatestHash() const override;
+    Hash256 getLatestHash() const override;
+    // Header of the block at `height`; throws std::out_of_range past the tip
+    const BlockHeader& getHeader(uint64_t height) const;
     void setValidators(const std::vector<Validator>& vals);
+    // Stakes above INT_MAX are clamped; getStake() returns the exact value
+    std::vector<Validator> getValidators() const;
+    // Stake changes between blocks, O(log n) each; they take effect for the
+    // next epoch's schedule and the next block's state root. deposit registers
+    // a new validator; withdraw and slash throw std::out_of_range for an
+    // unknown one, and withdraw std::invalid_argument past the stake.
+    void deposit(const std::string& validatorId, uint64_t amount);
+    void withdraw(const std::string& validatorId, uint64_t amount);
+    uint64_t slash(const std::string& validatorId, uint64_t amount);
+    // 0 for an unknown validator
+    uint64_t getStake(const std::string& validatorId) const;
+    size_t getEpochLength() const;
+    // Proposer of a slot in the current or an earlier epoch; empty if that
+    // epoch has not been scheduled yet or nobody had stake
+    std::string getProposer(uint64_t slot) const;
+    // Stakes epoch `epoch` is drawn from; throws std::out_of_range if its
+    // boundary block has not been added yet
+    const StakeSnapshot& getEpochStakes(size_t epoch) const;
+    // True if the snapshot is exactly the stake state committed by stateRoot
+    static bool verifyStakeSnapshot(const StakeSnapshot& snapshot, const Hash256& stateRoot);
+    Hash256 getStateRoot() const;
+    // Leaf value committed for a validator's stake
+    static Hash256 stakeValue(const Validator& validator);
+    static Hash256 stakeValue(const std::string& validatorId, uint64_t stake);
+    SparseMerkleProof getStakeProof(const std::string& validatorId) const;
 };
 
 #endif
\ No newline at end of file
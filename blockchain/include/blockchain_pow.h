@@ -4,21 +4,60 @@
 #include "blockchain.h"
 #include "block_pow.h"
 #include "merkle_tree.h"
+#include "pow.h"
+#include "mining_job.h"
+#include <memory>
+#include <utility>
 #include <vector>
 #include <string>
 
 class BlockchainPow : public Blockchain {
 private:
     std::vector<BlockPow*> chain;
+    MiningOptions miningOptions;
+    Hash256 target;
+    // Target schedule, kept with the chain: the compact target in force from
+    // each height on, in height order, one entry per actual change. Every
+    // header commits to the changes up to its height in its stateRoot, so
+    // isChainValid checks bits against the schedule the chain itself fixes
+    // and past entries cannot be rewritten.
+    std::vector<std::pair<uint64_t, uint32_t>> targetChanges;
+    std::vector<std::weak_ptr<MiningJob>> pendingJobs;
+
+    uint32_t requiredBits(uint64_t height) const;
+    Hash256 scheduleRoot(uint64_t height) const;
+    BlockHeader makeHeader(const Hash256& merkleRoot) const;
+    void appendBlock(BlockPow* block);
+    void cancelStaleJobs();
 
 public:
     BlockchainPow(int diff = 2);
     ~BlockchainPow() override;
     void addBlock(const std::vector<std::string>& transactions) override;
-    bool isChainValid() const;
+    bool isChainValid() const override;
     void displayChain() const;
+    // Difficulty in leading zero hex digits (4 bits each)
     void setDifficulty(int diff);
-    std::string getLatestHash() const override;
+    // Finer-grained difficulty: leading zero bits, or an arbitrary target
+    void setDifficultyBits(int bits);
+    void setTarget(const Hash256& t);
+    void setMiningOptions(const MiningOptions& options);
+    // Mines a block for `transactions` on a background thread, on top of the
+    // current tip. The chain stays usable meanwhile; once a block is appended
+    // on a different tip, the job is cancelled as stale.
+    MiningHandle submitMiningJob(const std::vector<std::string>& transactions,
+                                 const std::function<void(const MiningProgress&)>& onProgress = nullptr);
+    // Waits for the job and appends its block. Returns false if the job was
+    // cancelled, or the tip or the target changed since it was submitted.
+    bool commitMiningJob(const MiningHandle& handle);
+    Hash256 getLatestHash() const override;
+    // Header of the block at `height`; throws std::out_of_range past the tip
+    const BlockHeader& getHeader(uint64_t height) const;
+    // (height, bits) for every target change so far; the last one may take
+    // effect from the next block
+    const std::vector<std::pair<uint64_t, uint32_t>>& getTargetChanges() const;
+    // Commitment a header carries in stateRoot for `changes` up to `height`
+    static Hash256 commitTargetChanges(const std::vector<std::pair<uint64_t, uint32_t>>& changes, uint64_t height);
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,48 @@
+#ifndef HASH256_H
+#define HASH256_H
+
+#include <cstddef>
+#include <cstring>
+#include <string>
+
+// Fixed-size SHA-256 digest (32 raw bytes). Hashes are stored and compared in
+// binary form across the library; hex is only produced for display.
+struct Hash256 {
+    static const size_t SIZE = 32;
+    unsigned char bytes[SIZE];
+
+    Hash256() { std::memset(bytes, 0, SIZE); }
+    explicit Hash256(const unsigned char* raw) { std::memcpy(bytes, raw, SIZE); }
+
+    const unsigned char* data() const { return bytes; }
+    unsigned char* data() { return bytes; }
+
+    // An all-zero digest stands for "no hash" (empty tree, genesis parent).
+    bool empty() const;
+    std::string toHex() const;
+    static Hash256 fromHex(const std::string& hex);
+};
+
+inline bool operator==(const Hash256& a, const Hash256& b) {
+    return std::memcmp(a.bytes, b.bytes, Hash256::SIZE) == 0;
+}
+
+inline bool operator!=(const Hash256& a, const Hash256& b) {
+    return !(a == b);
+}
+
+// Byte-wise order, i.e. the digests compared as big-endian 256-bit integers.
+inline bool operator<(const Hash256& a, const Hash256& b) {
+    return std::memcmp(a.bytes, b.bytes, Hash256::SIZE) < 0;
+}
+
+// Digests are uniformly distributed, so any 8 bytes make a good bucket hash.
+struct Hash256Hasher {
+    size_t operator()(const Hash256& h) const {
+        size_t v;
+        std::memcpy(&v, h.bytes, sizeof(v));
+        return v;
+    }
+};
+
+#endif
@@ -0,0 +1,80 @@
+#ifndef KARY_MERKLE_TREE_H
+#define KARY_MERKLE_TREE_H
+
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "hash256.h"
+#include "merkle_levels.h"
+#include "thread_pool.h"
+
+// Audit path in a KaryMerkleTree: for each level from the leaves up, the
+// Arity - 1 other members of the path node's group, in group order.
+struct KaryMerkleProof {
+    size_t index;
+    std::vector<Hash256> siblings;
+};
+
+// Merkle tree whose parents hash groups of Arity children (the 32 * Arity
+// byte concatenation). Levels are built and stored by MerkleLevels, the same
+// code as MerkleTree, so KaryMerkleTree<2> has exactly MerkleTree's root and
+// proofs.
+//
+// Wider trees need fewer levels: an 8-ary proof takes log8(n) sequential
+// hashes instead of log2(n), each over a larger input. Every level is hashed
+// through sha256_batch, so the AVX2 kernel fills its eight lanes with groups.
+template <size_t Arity>
+class KaryMerkleTree {
+    static_assert(Arity >= 2, "KaryMerkleTree needs at least two children per node");
+
+private:
+    MerkleLevels levels;
+
+public:
+    // Builds on ThreadPool::shared(); the root does not depend on the pool.
+    explicit KaryMerkleTree(const std::vector<std::string>& transactions) : levels(Arity) {
+        levels.build(transactions, ThreadPool::shared());
+    }
+
+    KaryMerkleTree(const std::vector<std::string>& transactions, ThreadPool& pool) : levels(Arity) {
+        levels.build(transactions, pool);
+    }
+
+    Hash256 getRootHash() const {
+        return levels.getRootHash();
+    }
+
+    size_t getLeafCount() const {
+        return levels.getLeafCount();
+    }
+
+    size_t getLevelCount() const {
+        return levels.getLevelCount();
+    }
+
+    size_t getLevelSize(size_t level) const {
+        return levels.getLevelSize(level);
+    }
+
+    const Hash256& getNode(size_t level, size_t index) const {
+        return levels.getNode(level, index);
+    }
+
+    // Throws std::out_of_range if txIndex is not a leaf
+    KaryMerkleProof getProof(size_t txIndex) const {
+        if (txIndex >= getLeafCount()) {
+            throw std::out_of_range("KaryMerkleTree::getProof: no leaf " + std::to_string(txIndex));
+        }
+        KaryMerkleProof proof;
+        proof.index = txIndex;
+        proof.siblings = levels.getPath(txIndex);
+        return proof;
+    }
+
+    static bool verifyProof(const Hash256& leafHash, const KaryMerkleProof& proof, const Hash256& rootHash) {
+        return MerkleLevels::verifyPath(leafHash, proof.index, proof.siblings, Arity, rootHash);
+    }
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,47 @@
+#ifndef MERKLE_ACCUMULATOR_H
+#define MERKLE_ACCUMULATOR_H
+
+#include <cstddef>
+#include <istream>
+#include <string>
+#include <vector>
+#include "hash256.h"
+
+// Append-only Merkle root over a growing list of transactions, for block
+// templates that are filled one transaction at a time. Only the right edge
+// ("frontier") of the tree is kept: frontier[h] is the root of the last
+// complete subtree of 2^h leaves, valid when bit h of the leaf count is set.
+// Appending and computing the root are both O(log n), and the root equals
+// MerkleTree's for the same leaves (odd levels duplicate their last node).
+//
+// Because memory is O(log n), it can also compute roots over inputs too large
+// to hold at once: the append* helpers below stream transactions from an
+// iterator range, a stream, or a file, hashing leaves in batches.
+class MerkleAccumulator {
+private:
+    std::vector<Hash256> frontier;
+    size_t leafCount;
+
+    void appendBatch(const unsigned char* const* transactions, const size_t* lengths, size_t count);
+
+public:
+    MerkleAccumulator();
+    void append(const std::string& transaction);
+    void appendHash(const Hash256& leafHash);
+    template <typename InputIt>
+    void appendRange(InputIt first, InputIt last) {
+        for (; first != last; ++first) append(*first);
+    }
+    // One transaction per line (std::getline semantics). Return the number of
+    // transactions appended.
+    size_t appendLines(std::istream& in);
+    // Memory-maps the file where supported. Throws std::runtime_error if it
+    // cannot be read.
+    size_t appendFile(const std::string& path);
+    size_t size() const;
+    // Hash256() when nothing has been appended
+    Hash256 getRootHash() const;
+    void clear();
+};
+
+#endif
\ No newline at end of file
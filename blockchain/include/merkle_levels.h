@@ -0,0 +1,51 @@
+#ifndef MERKLE_LEVELS_H
+#define MERKLE_LEVELS_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "hash256.h"
+#include "thread_pool.h"
+
+// Level storage shared by MerkleTree and KaryMerkleTree: every level of a
+// tree whose parents hash groups of `arity` children, in one contiguous
+// array of digests (the leaves first, the root last). A level's last group
+// is padded by repeating its last node. Nodes are addressed as (level,
+// index); the children of (l, i) are (l - 1, arity * i ...), so no pointers
+// are stored.
+class MerkleLevels {
+private:
+    size_t arity;
+    std::vector<Hash256> nodes;
+    // levelOffsets[l] is the index of level l's first node in `nodes`;
+    // one extra trailing entry holds nodes.size().
+    std::vector<size_t> levelOffsets;
+
+public:
+    // Each pool thread hashes at least this many nodes of a level, so levels
+    // narrower than twice this are hashed serially.
+    static const size_t MIN_PARALLEL_CHUNK = 2048;
+
+    explicit MerkleLevels(size_t arity);
+    // Every node of a level depends only on the level below, so each level
+    // is split into independent ranges across the pool. The root does not
+    // depend on the pool.
+    void build(const std::vector<std::string>& transactions, ThreadPool& pool);
+
+    size_t getArity() const;
+    Hash256 getRootHash() const;
+    size_t getLeafCount() const;
+    // Number of levels including leaves and root; 0 for an empty tree
+    size_t getLevelCount() const;
+    size_t getLevelSize(size_t level) const;
+    const Hash256& getNode(size_t level, size_t index) const;
+
+    // For each level from the leaves up, the arity - 1 other members of the
+    // path node's group, in group order. txIndex must be a leaf.
+    std::vector<Hash256> getPath(size_t txIndex) const;
+    // Rehashes a getPath() result up from the leaf at `index`
+    static bool verifyPath(const Hash256& leafHash, size_t index, const std::vector<Hash256>& siblings,
+                           size_t arity, const Hash256& rootHash);
+};
+
+#endif
\ No newline at end of file
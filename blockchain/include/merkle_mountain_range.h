@@ -0,0 +1,50 @@
+#ifndef MERKLE_MOUNTAIN_RANGE_H
+#define MERKLE_MOUNTAIN_RANGE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "hash256.h"
+
+// Inclusion proof for one leaf of a MerkleMountainRange: the path up to the
+// leaf's mountain peak, plus every peak (highest mountain first) so the
+// verifier can rebuild the root.
+struct MmrProof {
+    uint64_t leafIndex;
+    uint64_t leafCount;
+    std::vector<Hash256> siblings;
+    std::vector<Hash256> peaks;
+};
+
+// Append-only commitment over a sequence of hashes (the chain's block
+// hashes). The leaves form a list of perfect binary trees ("mountains"), one
+// per set bit of the leaf count, tallest first. Appending merges equal-height
+// mountains, like a binary increment, and nothing already stored changes, so
+// a proof only needs the leaf's path to its peak plus the O(log n) peaks.
+//
+// The root hashes the leaf count followed by the peaks, tallest first.
+class MerkleMountainRange {
+private:
+    // nodes[h] holds every complete subtree of height h, left to right
+    std::vector<std::vector<Hash256>> nodes;
+
+public:
+    void append(const Hash256& leaf);
+    uint64_t size() const;
+    // Hash256() when empty
+    Hash256 getRootHash() const;
+    std::vector<Hash256> getPeaks() const;
+    // Throws std::out_of_range if leafIndex >= size()
+    MmrProof getProof(uint64_t leafIndex) const;
+
+    // The same, for the range as it was after its first leafCount appends.
+    // Earlier nodes never change, so old roots stay provable. Throw
+    // std::out_of_range if leafCount > size() (or leafIndex >= leafCount).
+    Hash256 getRootHash(uint64_t leafCount) const;
+    std::vector<Hash256> getPeaks(uint64_t leafCount) const;
+    MmrProof getProof(uint64_t leafIndex, uint64_t leafCount) const;
+    static Hash256 bagPeaks(uint64_t leafCount, const std::vector<Hash256>& peaks);
+    static bool verifyProof(const Hash256& leaf, const MmrProof& proof, const Hash256& rootHash);
+};
+
+#endif
\ No newline at end of file
@@ -2,34 +2,76 @@
 #define MERKLE_TREE_H
 
 #include <string>
+#include <unordered_map>
 #include <vector>
+#include "hash256.h"
+#include "merkle_levels.h"
+#include "thread_pool.h"
 
-class MerkleNode {
-public:
-    std::string hash;
-    MerkleNode* left;
-    MerkleNode* right;
+// Audit path for one leaf: the sibling digest at each level from the leaves
+// up. Bit l of `index` says whether the path node at level l is a right child.
+struct MerkleProof {
+    size_t index;
+    std::vector<Hash256> siblings;
+};
 
-    MerkleNode(const std::string& data);
-    MerkleNode(MerkleNode* l, MerkleNode* r);
-    ~MerkleNode();
+// Proof for several leaves of one tree at once. `indices` is sorted and
+// unique; `hashes` holds only the siblings that cannot be recomputed from
+// the proven leaves, level by level from the leaves up and left to right
+// within a level. leafCount fixes the shape of the tree.
+struct MerkleMultiProof {
+    size_t leafCount;
+    std::vector<size_t> indices;
+    std::vector<Hash256> hashes;
 };
 
+// Binary Merkle tree stored level by level in one contiguous array of
+// digests (MerkleLevels with arity 2): the leaves first, then each parent
+// level, the root last. A level with an odd number of nodes pairs its last
+// node with itself. Nodes are addressed as (level, index); the children of
+// (l, i) are (l - 1, 2i) and (l - 1, 2i + 1), so no pointers are stored.
 class MerkleTree {
 private:
-    MerkleNode* root;
+    MerkleLevels levels;
+    // Optional leaf digest -> first leaf position; empty until buildLeafIndex()
+    std::unordered_map<Hash256, size_t, Hash256Hasher> leafIndex;
 
-    MerkleNode* buildTreeRecursive(std::vector<MerkleNode*>& nodes);
-    bool searchHash(MerkleNode* node, const std::string& targetHash) const;
+    void printTree(size_t level, size_t index, int depth) const;
 
 public:
+    // Each pool thread hashes at least this many nodes of a level, so levels
+    // narrower than twice this are hashed serially.
+    static const size_t MIN_PARALLEL_CHUNK = MerkleLevels::MIN_PARALLEL_CHUNK;
+
+    // Builds on ThreadPool::shared(); the root does not depend on the pool.
     MerkleTree(const std::vector<std::string>& transactions);
-    std::string getRootHash() const;
-    void printTree(MerkleNode* node, int depth = 0) const;
+    MerkleTree(const std::vector<std::string>& transactions, ThreadPool& pool);
+    Hash256 getRootHash() const;
     void printTree() const;
     bool verifyTransaction(const std::string& transaction) const;
+    // Makes leaf lookups (verifyTransaction, findLeaf) O(1) instead of a scan
+    // of the leaf level, for trees that answer many membership queries.
+    void buildLeafIndex();
+    bool hasLeafIndex() const;
+    // Position of the first leaf with this digest; false if absent
+    bool findLeaf(const Hash256& leafHash, size_t& txIndex) const;
+    // Throws std::out_of_range if txIndex is not a leaf
+    MerkleProof getProof(size_t txIndex) const;
+    // Recomputes the root from a leaf and its audit path (log2(n) hashes)
+    static bool verifyProof(const Hash256& leafHash, const MerkleProof& proof, const Hash256& rootHash);
+    static bool verifyProof(const std::string& transaction, const MerkleProof& proof, const Hash256& rootHash);
+    // Indices may be unsorted or repeated. Throws std::out_of_range if any is
+    // not a leaf.
+    MerkleMultiProof getMultiProof(const std::vector<size_t>& txIndices) const;
+    // leafHashes[k] is the digest of leaf proof.indices[k]. Every ancestor
+    // shared by the proven leaves is hashed once.
+    static bool verifyMultiProof(const std::vector<Hash256>& leafHashes, const MerkleMultiProof& proof, const Hash256& rootHash);
 
-    ~MerkleTree();
+    size_t getLeafCount() const;
+    // Number of levels including leaves and root; 0 for an empty tree
+    size_t getLevelCount() const;
+    size_t getLevelSize(size_t level) const;
+    const Hash256& getNode(size_t level, size_t index) const;
 };
 
 #endif
@@ -0,0 +1,58 @@
+#ifndef MINING_JOB_H
+#define MINING_JOB_H
+
+#include <atomic>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include "hash256.h"
+#include "block_header.h"
+#include "pow.h"
+
+struct MiningResult {
+    Hash256 hash;
+    uint64_t nonce;
+    uint32_t extraNonce;
+};
+
+// A block template being mined in the background. Everything the worker needs
+// is copied in at submission, so mining never touches the chain itself.
+struct MiningJob {
+    BlockHeader header;
+    MiningOptions options;
+    std::atomic<bool> cancelFlag;
+    mutable std::mutex progressMutex;
+    MiningProgress lastProgress;
+    // Declared last: destroying it joins the worker while the fields above
+    // are still alive.
+    std::shared_future<MiningResult> result;
+
+    MiningJob(const BlockHeader& hdr, const MiningOptions& opts);
+    ~MiningJob();
+};
+
+// Caller-side view of a MiningJob. Copies share the same job.
+class MiningHandle {
+private:
+    std::shared_ptr<MiningJob> job;
+
+public:
+    MiningHandle();
+    explicit MiningHandle(const std::shared_ptr<MiningJob>& j);
+    bool valid() const;
+    bool ready() const;
+    void cancel();
+    bool cancelled() const;
+    MiningProgress progress() const;
+    // Blocks until the job ends; throws MiningCancelled if it was cancelled,
+    // std::logic_error if the handle has no started job (see valid()).
+    MiningResult get() const;
+    std::shared_ptr<MiningJob> getJob() const;
+};
+
+// Launches the job on its own thread. `onProgress` (optional) runs on a mining
+// thread each time the job's progress snapshot is refreshed.
+MiningHandle startMiningJob(const std::shared_ptr<MiningJob>& job, const std::function<void(const MiningProgress&)>& onProgress);
+
+#endif
\ No newline at end of file
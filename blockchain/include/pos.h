@@ -1,14 +1,51 @@
 #ifndef POS_H
 #define POS_H
 
+#include <cstdint>
 #include <string>
 #include <vector>
+#include "hash256.h"
+#include "stake_index.h"
+#include "proposer_schedule.h"
+#include "block_header.h"
 #include "validator.h"
 
+// Counter-based generator (SplitMix64 output function) keyed by
+// sha256(previousHash || slot). Output i is a pure function of the key and i,
+// so any node can replay a slot's draws; seeding costs one hash.
+class ProposerRng {
+private:
+    uint64_t key;
+    uint64_t counter;
+
+public:
+    typedef uint64_t result_type;
+    ProposerRng(const Hash256& previousHash, uint64_t slot);
+    uint64_t operator()();
+    // Uniform in [0, bound) by rejection, identical on every platform
+    // (unlike std::uniform_int_distribution). bound must be non-zero.
+    uint64_t nextBelow(uint64_t bound);
+    static constexpr uint64_t min() { return 0; }
+    static constexpr uint64_t max() { return UINT64_MAX; }
+};
+
 class ProofOfStake {
 public:
-    static std::string validateBlock(const std::string& data, const std::string& previousHash, std::vector<Validator>& validators, std::string& selectedValidator);
-    static bool verifyBlock(const std::string& data, const std::string& previousHash, const std::string& hash, const std::string& validator);
+    // header.hashWithProposer(validator): the header carries the stake state
+    // root, and the seal adds the proposer's id.
+    static Hash256 sealHash(const BlockHeader& header, const std::string& validator);
+    // Proposer for slot header.height on top of header.previousHash: the
+    // stake-weighted draw given by ProposerRng. Empty if nobody has stake.
+    static std::string selectProposer(const Hash256& previousHash, uint64_t slot, const StakeIndex& stakes);
+    // Deterministic selection (selectProposer) from a plain vector, O(n)
+    static Hash256 validateBlock(const BlockHeader& header, std::vector<Validator>& validators, std::string& selectedValidator);
+    // Deterministic O(log n) selection from a stake index
+    static Hash256 validateBlock(const BlockHeader& header, const StakeIndex& stakes,
+                                 std::string& selectedValidator);
+    // O(1) selection from a precomputed epoch schedule covering header.height
+    static Hash256 validateBlock(const BlockHeader& header, const ProposerSchedule& schedule,
+                                 std::string& selectedValidator);
+    static bool verifyBlock(const BlockHeader& header, const Hash256& hash, const std::string& validator);
 };
 
 #endif
\ No newline at end of file
@@ -2,11 +2,62 @@
 #define POW_H
 
 #include <string>
+#include <cstdint>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <stdexcept>
+#include "hash256.h"
+#include "block_header.h"
 
+struct MiningProgress {
+    uint64_t attempts;
+    double hashesPerSecond;
+};
+
+// Thrown by ProofOfWork::mineBlock when MiningOptions::cancel is raised.
+class MiningCancelled : public std::runtime_error {
+public:
+    MiningCancelled() : std::runtime_error("mining cancelled") {}
+};
+
+// How ProofOfWork::mineBlock searches the nonce space.
+struct MiningOptions {
+    // Worker threads; 0 uses std::thread::hardware_concurrency().
+    unsigned threads;
+    // Report the lowest winning nonce (the single-threaded answer) instead of
+    // whichever worker finds a solution first.
+    bool deterministic;
+    // Polled by the workers every few thousand attempts; null means never.
+    const std::atomic<bool>* cancel;
+    // Called from a mining thread about every progressInterval.
+    std::function<void(const MiningProgress&)> onProgress;
+    std::chrono::milliseconds progressInterval;
+
+    MiningOptions(unsigned t = 1, bool det = true)
+        : threads(t), deterministic(det), cancel(nullptr), progressInterval(500) {}
+};
+
+// Difficulty is a 256-bit target: a block is valid when its header hash, read
+// as a big-endian integer, is <= target. One leading zero hex digit equals 4
+// bits. Headers carry the target in compact form (header.bits).
+// The search starts at the header's (extraNonce, nonce) and walks the 96-bit
+// counter extraNonce:nonce; the extra-nonce is rolled when the nonce wraps.
+// On success the header holds the winning nonces.
 class ProofOfWork {
 public:
-    static std::string mineBlock(const std::string& data, const std::string& previousHash, int difficulty, int& nonce);
-    static bool verifyBlock(const std::string& data, const std::string& previousHash, const std::string& hash, int difficulty, int nonce);
+    static Hash256 mineBlock(BlockHeader& header);
+    static Hash256 mineBlock(BlockHeader& header, const MiningOptions& options);
+    static bool verifyBlock(const BlockHeader& header, const Hash256& hash);
+
+    // Largest target whose hashes start with `bits` zero bits (2^(256-bits) - 1).
+    static Hash256 targetFromZeroBits(int bits);
+    // Bitcoin-style "nBits": one size byte and a 3-byte mantissa. Encoding
+    // keeps the 3 most significant bytes, so it can lower a target slightly.
+    static uint32_t compactFromTarget(const Hash256& target);
+    static Hash256 targetFromCompact(uint32_t bits);
+    static int leadingZeroBits(const Hash256& hash);
+    static bool meetsTarget(const Hash256& hash, const Hash256& target);
 };
 
 #endif
\ No newline at end of file
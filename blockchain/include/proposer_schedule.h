@@ -0,0 +1,48 @@
+#ifndef PROPOSER_SCHEDULE_H
+#define PROPOSER_SCHEDULE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "hash256.h"
+#include "stake_index.h"
+
+// Stakes an epoch is drawn from: every validator's (id, stake) as committed
+// by the stake state root of the epoch's boundary block, sorted by
+// SparseMerkleTree::keyFor(id). A state root therefore fixes both the list
+// and its order, and anyone holding the root can check a snapshot
+// (BlockchainPos::verifyStakeSnapshot) before rebuilding the schedule.
+struct StakeSnapshot {
+    std::vector<std::string> ids;
+    std::vector<uint64_t> stakes;
+
+    static StakeSnapshot of(const StakeIndex& index);
+    // Index over the snapshot in its key order, for ProposerSchedule::build
+    StakeIndex toIndex() const;
+};
+
+// Proposers for every slot of one epoch, drawn in a single batch when the
+// epoch starts. The draws come from ProposerRng keyed by the epoch seed (the
+// hash of the block before the epoch) and the first slot, over the stake
+// snapshot taken at that block, so stake changes apply from the next epoch.
+//
+// Storage is one 32-bit index per slot into the epoch's distinct proposers.
+struct ProposerSchedule {
+    static const size_t DEFAULT_EPOCH_LENGTH = 32;
+
+    uint64_t firstSlot;
+    Hash256 seed;
+    std::vector<std::string> ids;
+    std::vector<uint32_t> proposers;
+
+    ProposerSchedule();
+    // Leaves the schedule empty (no proposers) if nobody has stake
+    static ProposerSchedule build(const Hash256& seed, uint64_t firstSlot, size_t length, const StakeIndex& stakes);
+    bool empty() const;
+    bool covers(uint64_t slot) const;
+    // O(1); slot must be covered
+    const std::string& proposerAt(uint64_t slot) const;
+};
+
+#endif
\ No newline at end of file
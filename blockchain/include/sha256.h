@@ -0,0 +1,39 @@
+#ifndef SHA256_H
+#define SHA256_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "hash256.h"
+
+// SHA-256 implementations the batch API can dispatch to. The best one the CPU
+// supports is picked once via CPUID; SCALAR is always available.
+enum Sha256Backend {
+    SHA256_BACKEND_SCALAR,
+    SHA256_BACKEND_AVX2,
+    SHA256_BACKEND_SHANI
+};
+
+Sha256Backend sha256Backend();
+const char* sha256BackendName(Sha256Backend backend);
+bool sha256BackendSupported(Sha256Backend backend);
+// Overrides the detected backend (benchmarks/tests). Returns false and keeps
+// the current one if the CPU lacks the requested instructions.
+bool setSha256Backend(Sha256Backend backend);
+
+extern const uint32_t SHA256_INITIAL_STATE[8];
+
+// Runs the compression function over `blockCount` consecutive 64-byte blocks
+// (no padding). Uses SHA-NI when that backend is active, portable C otherwise.
+void sha256Compress(uint32_t state[8], const unsigned char* blocks, size_t blockCount);
+
+// Hashes `count` independent messages in one call. The AVX2 kernel runs eight
+// messages per pass (one per 32-bit lane); SHA-NI hashes them back to back.
+// Messages may differ in length, but batches of equal-length messages (Merkle
+// levels, nonce candidates, block headers) keep every lane busy.
+void sha256_batch(const unsigned char* const* messages, const size_t* lengths, size_t count, Hash256* digests);
+void sha256_batch(const unsigned char* const* messages, size_t length, size_t count, Hash256* digests);
+std::vector<Hash256> sha256_batch(const std::vector<std::string>& messages);
+
+#endif
@@ -0,0 +1,74 @@
+#ifndef SPARSE_MERKLE_TREE_H
+#define SPARSE_MERKLE_TREE_H
+
+#include <cstddef>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "hash256.h"
+
+// Path from the root down to the subtree where a key's search ends: one
+// sibling per level descended, then that subtree's only leaf (if any).
+struct SparseMerkleProof {
+    std::vector<Hash256> siblings;
+    bool hasLeaf;
+    Hash256 leafKey;
+    Hash256 leafValue;
+};
+
+// Authenticated key/value map over the full 256-bit key space (account ids
+// are keyed by sha256(id)). A key's bits, most significant first, are its
+// path from the root; node hashes are defined by subtree contents:
+//
+//   no leaves         defaultHash(height): zero at height 0, then
+//                     sha256(d, d) of the level below, precomputed
+//   exactly one leaf  leafHash(key, value), at whatever height
+//   otherwise         sha256(left, right)
+//
+// Collapsing single-leaf subtrees keeps paths about log2(n) deep instead of
+// 256. Subtrees with two or more leaves are cached, and updates only mark
+// keys dirty. The next getRootHash() rehashes just the dirty paths, so an
+// update costs O(log n) hashes and ancestors shared by a batch are rehashed
+// once.
+class SparseMerkleTree {
+private:
+    std::map<Hash256, Hash256> leaves;
+    // cache[h] maps the key prefix of a height-h subtree with 2+ leaves to its hash
+    mutable std::vector<std::unordered_map<Hash256, Hash256, Hash256Hasher>> cache;
+    mutable std::vector<Hash256> dirty;
+    mutable Hash256 root;
+
+    typedef std::map<Hash256, Hash256>::const_iterator LeafIt;
+    typedef std::vector<Hash256>::const_iterator DirtyIt;
+
+    Hash256 nodeHash(size_t height, const Hash256& prefix, LeafIt first, LeafIt last, DirtyIt dirtyFirst, DirtyIt dirtyLast) const;
+    void purge(size_t height, const std::vector<Hash256>& keys) const;
+    void refresh() const;
+
+public:
+    static const size_t DEPTH = 256;
+
+    SparseMerkleTree();
+    static Hash256 keyFor(const std::string& accountId);
+    static const Hash256& defaultHash(size_t height);
+    static Hash256 leafHash(const Hash256& key, const Hash256& value);
+
+    // An empty (all-zero) value removes the key
+    void update(const Hash256& key, const Hash256& value);
+    void update(const std::vector<std::pair<Hash256, Hash256>>& updates);
+    // Hash256() if absent
+    Hash256 get(const Hash256& key) const;
+    size_t size() const;
+    // Interior nodes cached once pending updates are applied: one per
+    // subtree with two or more leaves.
+    size_t getCacheSize() const;
+    Hash256 getRootHash() const;
+
+    SparseMerkleProof getProof(const Hash256& key) const;
+    // Checks key -> value against the root; an empty value proves absence.
+    static bool verifyProof(const Hash256& key, const Hash256& value, const SparseMerkleProof& proof, const Hash256& rootHash);
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,61 @@
+#ifndef STAKE_INDEX_H
+#define STAKE_INDEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+#include "validator.h"
+#include "validator_registry.h"
+
+// Validator stakes in a Fenwick (binary indexed) tree, for stake sets that
+// change every block. Deposits, withdrawals and slashing adjust one slot in
+// O(log n), and a stake-weighted draw is a single O(log n) descent over the
+// prefix sums, with no table to rebuild (compare AliasTable).
+class StakeIndex {
+private:
+    // Ids and per-slot stakes; tree is indexed by the same slots
+    ValidatorRegistry registry;
+    // 1-based Fenwick array: tree[i] sums stakes (i - lowbit(i), i]
+    std::vector<uint64_t> tree;
+    uint64_t total;
+
+    void add(size_t slot, uint64_t amount);
+    void subtract(size_t slot, uint64_t amount);
+    size_t slotOf(const std::string& id) const;
+
+public:
+    StakeIndex();
+    explicit StakeIndex(const std::vector<Validator>& validators);
+    // Replaces the whole set in O(n). Negative stakes count as zero.
+    void assign(const std::vector<Validator>& validators);
+
+    // Registers the validator if it is new
+    void deposit(const std::string& id, uint64_t amount);
+    // Throws std::out_of_range for an unknown id, std::invalid_argument if
+    // amount exceeds the stake
+    void withdraw(const std::string& id, uint64_t amount);
+    // Burns up to `amount` and returns how much was actually taken
+    uint64_t slash(const std::string& id, uint64_t amount);
+
+    bool contains(const std::string& id) const;
+    uint64_t stakeOf(const std::string& id) const;
+    uint64_t totalStake() const;
+    size_t size() const;
+    const std::string& idAt(size_t slot) const;
+    // Stakes above INT_MAX are clamped (see ValidatorRegistry::toValidators)
+    std::vector<Validator> toValidators() const;
+    const ValidatorRegistry& getRegistry() const;
+
+    // Slot holding the point `offset` in [0, totalStake()) of the stakes laid
+    // end to end; zero-stake slots are never returned.
+    size_t findByOffset(uint64_t offset) const;
+    template <typename URNG>
+    size_t sample(URNG& gen) const {
+        std::uniform_int_distribution<uint64_t> point(0, total - 1);
+        return findByOffset(point(gen));
+    }
+};
+
+#endif
\ No newline at end of file
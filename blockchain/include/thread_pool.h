@@ -0,0 +1,43 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of worker threads for data-parallel loops. The thread calling
+// parallelFor runs a share of the work too, so a pool of size n starts n - 1
+// workers and a pool of size 1 runs everything inline.
+class ThreadPool {
+private:
+    std::vector<std::thread> workers;
+    std::deque<std::function<void()>> tasks;
+    std::mutex mutex;
+    std::condition_variable available;
+    bool stopping;
+
+    void workerLoop();
+
+public:
+    // 0 uses std::thread::hardware_concurrency()
+    explicit ThreadPool(unsigned threads = 0);
+    ~ThreadPool();
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    size_t size() const;
+    // Splits [0, count) into at most size() contiguous ranges of at least
+    // minChunk items and calls body(begin, end) on each, returning once all
+    // are done. body must not throw, and must not call parallelFor on the
+    // same pool (its workers would wait on each other).
+    void parallelFor(size_t count, size_t minChunk, const std::function<void(size_t, size_t)>& body);
+
+    // Process-wide pool sized to the machine, created on first use.
+    static ThreadPool& shared();
+};
+
+#endif
\ No newline at end of file
@@ -4,11 +4,42 @@
 #include <string>
 #include <chrono>
 #include <ctime>
+#include <cstdint>
 #include <openssl/sha.h>
+#include "hash256.h"
 
 // Declarations for utility functions. Implementations live in src/utils.cpp
-std::string sha256(const std::string& input);
+Hash256 sha256(const std::string& input);
+Hash256 sha256(const void* data, size_t length);
+// Digest of the 64-byte concatenation left || right (Merkle parent nodes).
+Hash256 sha256(const Hash256& left, const Hash256& right);
 std::string getCurrentTime();
+// Milliseconds since the Unix epoch; the value stored in block headers.
+int64_t currentTimestamp();
+// Local-time rendering of a stored timestamp, for display only.
+std::string formatTimestamp(int64_t millis);
+
+// Incremental SHA-256: feed block fields one by one instead of concatenating
+// them into a temporary string. The state is a plain value, so a hasher that
+// has absorbed a common prefix can be copied and finished per candidate.
+class Sha256Hasher {
+private:
+    uint32_t state[8];
+    unsigned char buffer[64];
+    size_t buffered;
+    uint64_t totalLength;
+
+public:
+    Sha256Hasher();
+    Sha256Hasher& update(const void* data, size_t length);
+    Sha256Hasher& update(const std::string& data);
+    Sha256Hasher& update(const Hash256& digest);
+    // Fixed-width little-endian integer encodings
+    Sha256Hasher& updateUint32(uint32_t value);
+    Sha256Hasher& updateUint64(uint64_t value);
+    // Digest of everything fed so far; the hasher itself is left untouched.
+    Hash256 finalize() const;
+};
 
 // Template must be defined in header. Return microseconds for better granularity.
 template<typename F>
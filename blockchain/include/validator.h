@@ -4,6 +4,9 @@
 #include <string>
 #include <vector>
 
+class AliasTable;
+class ValidatorRegistry;
+
 class Validator {
 public:
     std::string id;
@@ -13,7 +16,11 @@ public:
 
     // Validator selection and validation methods
     static std::string selectValidator(const std::vector<Validator>& validators);
+    // O(1) per call with a table built over the same validators
+    static std::string selectValidator(const std::vector<Validator>& validators, const AliasTable& selector);
     static bool validateStake(const std::vector<Validator>& validators, const std::string& selectedId);
+    // O(1) hash lookup instead of a scan over the ids
+    static bool validateStake(const ValidatorRegistry& registry, const std::string& selectedId);
 };
 
 #endif
\ No newline at end of file
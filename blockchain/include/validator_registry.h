@@ -0,0 +1,52 @@
+#ifndef VALIDATOR_REGISTRY_H
+#define VALIDATOR_REGISTRY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "validator.h"
+
+// Validator ids interned into dense slots 0..n-1, with each field kept in
+// its own array indexed by slot. An open-addressing table (linear probing,
+// load <= 1/2) maps an id to its slot in O(1) expected time; stakes are
+// then read and updated in place. Validators are never removed one by one;
+// assign() replaces the whole set.
+class ValidatorRegistry {
+private:
+    std::vector<std::string> ids;
+    std::vector<uint64_t> hashes;
+    std::vector<uint64_t> stakes;
+    // Power-of-two table of slot + 1; 0 marks an empty bucket
+    std::vector<uint32_t> buckets;
+
+    static uint64_t hashId(const std::string& id);
+    size_t probe(const std::string& id, uint64_t hash) const;
+    void grow();
+
+public:
+    static const size_t NPOS = static_cast<size_t>(-1);
+
+    ValidatorRegistry();
+    explicit ValidatorRegistry(const std::vector<Validator>& validators);
+    // Replaces the whole set; a repeated id keeps its first slot and its last
+    // stake. Negative stakes count as zero.
+    void assign(const std::vector<Validator>& validators);
+    void clear();
+
+    // Slot of `id`, registering it with zero stake if it is new
+    size_t intern(const std::string& id);
+    // Slot of `id`, or NPOS if it is not registered
+    size_t find(const std::string& id) const;
+    bool contains(const std::string& id) const;
+
+    size_t size() const;
+    const std::string& idAt(size_t slot) const;
+    uint64_t stakeAt(size_t slot) const;
+    void setStake(size_t slot, uint64_t stake);
+    // Validator::stake is an int: stakes above INT_MAX are clamped to it.
+    // Read exact values through stakeAt().
+    std::vector<Validator> toValidators() const;
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,64 @@
+#include "alias_table.h"
+
+AliasTable::AliasTable() {}
+
+AliasTable::AliasTable(const std::vector<Validator>& validators) {
+    build(validators);
+}
+
+void AliasTable::build(const std::vector<Validator>& validators) {
+    probability.clear();
+    alias.clear();
+    double totalStake = 0;
+    for (const auto& v : validators) {
+        if (v.stake > 0) totalStake += v.stake;
+    }
+    if (totalStake <= 0) return;
+
+    size_t n = validators.size();
+    probability.resize(n);
+    alias.resize(n);
+    // Scale so the average column weight is 1, then pair each underfull
+    // column with an overfull one that tops it up.
+    std::vector<double> scaled(n);
+    std::vector<uint32_t> small, large;
+    uint32_t lastLarge = 0;
+    for (size_t i = 0; i < n; i++) {
+        scaled[i] = validators[i].stake > 0 ? validators[i].stake * n / totalStake : 0.0;
+        if (scaled[i] < 1.0) small.push_back(static_cast<uint32_t>(i));
+        else large.push_back(static_cast<uint32_t>(i));
+    }
+    while (!small.empty() && !large.empty()) {
+        uint32_t less = small.back();
+        small.pop_back();
+        uint32_t more = large.back();
+        lastLarge = more;
+        probability[less] = scaled[less];
+        alias[less] = more;
+        scaled[more] -= 1.0 - scaled[less];
+        if (scaled[more] < 1.0) {
+            large.pop_back();
+            small.push_back(more);
+        }
+    }
+    // Whatever is left is 1 up to rounding error; zero-stake columns must
+    // still never yield themselves.
+    for (uint32_t i : large) {
+        probability[i] = 1.0;
+        alias[i] = i;
+        lastLarge = i;
+    }
+    for (uint32_t i : small) {
+        bool staked = validators[i].stake > 0;
+        probability[i] = staked ? 1.0 : 0.0;
+        alias[i] = staked ? i : lastLarge;
+    }
+}
+
+bool AliasTable::empty() const {
+    return probability.empty();
+}
+
+size_t AliasTable::size() const {
+    return probability.size();
+}
\ No newline at end of file
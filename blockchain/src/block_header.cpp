@@ -0,0 +1,74 @@
+#include "block_header.h"
+#include "utils.h"
+#include <cstring>
+
+static void putUint32(unsigned char* out, uint32_t value) {
+    for (int i = 0; i < 4; i++) out[i] = static_cast<unsigned char>(value >> (8 * i));
+}
+
+static void putUint64(unsigned char* out, uint64_t value) {
+    for (int i = 0; i < 8; i++) out[i] = static_cast<unsigned char>(value >> (8 * i));
+}
+
+static uint32_t getUint32(const unsigned char* in) {
+    uint32_t value = 0;
+    for (int i = 3; i >= 0; i--) value = (value << 8) | in[i];
+    return value;
+}
+
+static uint64_t getUint64(const unsigned char* in) {
+    uint64_t value = 0;
+    for (int i = 7; i >= 0; i--) value = (value << 8) | in[i];
+    return value;
+}
+
+const size_t BlockHeader::SIZE;
+const size_t BlockHeader::MIDSTATE_SIZE;
+const size_t BlockHeader::EXTRA_NONCE_OFFSET;
+const size_t BlockHeader::NONCE_OFFSET;
+const uint32_t BlockHeader::CURRENT_VERSION;
+
+BlockHeader::BlockHeader()
+    : version(CURRENT_VERSION), height(0), timestamp(0), bits(0), extraNonce(0), nonce(0) {}
+
+void BlockHeader::serialize(unsigned char out[SIZE]) const {
+    std::memcpy(out, previousHash.data(), Hash256::SIZE);
+    std::memcpy(out + 32, merkleRoot.data(), Hash256::SIZE);
+    std::memcpy(out + 64, historyRoot.data(), Hash256::SIZE);
+    std::memcpy(out + 96, stateRoot.data(), Hash256::SIZE);
+    putUint32(out + 128, version);
+    putUint32(out + 132, height);
+    putUint64(out + 136, static_cast<uint64_t>(timestamp));
+    putUint32(out + 144, bits);
+    putUint32(out + EXTRA_NONCE_OFFSET, extraNonce);
+    putUint64(out + NONCE_OFFSET, nonce);
+}
+
+BlockHeader BlockHeader::deserialize(const unsigned char in[SIZE]) {
+    BlockHeader header;
+    header.previousHash = Hash256(in);
+    header.merkleRoot = Hash256(in + 32);
+    header.historyRoot = Hash256(in + 64);
+    header.stateRoot = Hash256(in + 96);
+    header.version = getUint32(in + 128);
+    header.height = getUint32(in + 132);
+    header.timestamp = static_cast<int64_t>(getUint64(in + 136));
+    header.bits = getUint32(in + 144);
+    header.extraNonce = getUint32(in + EXTRA_NONCE_OFFSET);
+    header.nonce = getUint64(in + NONCE_OFFSET);
+    return header;
+}
+
+Hash256 BlockHeader::hash() const {
+    unsigned char bytes[SIZE];
+    serialize(bytes);
+    return sha256(bytes, SIZE);
+}
+
+Hash256 BlockHeader::hashWithProposer(const std::string& proposer) const {
+    unsigned char bytes[SIZE];
+    serialize(bytes);
+    Sha256Hasher hasher;
+    hasher.update(bytes, SIZE).update(proposer);
+    return hasher.finalize();
+}
\ No newline at end of file
@@ -2,44 +2,54 @@
 #include "utils.h"
 #include "pos.h"
 #include <iostream>
-#include <sstream>
 
-BlockPos::BlockPos(int idx, const std::string& prevHash, const std::string& h, const std::string& d, const std::string& v)
-    : index(idx), previousHash(prevHash), hash(h), data(d), validator(v) {}
+BlockPos::BlockPos(const BlockHeader& hdr, const Hash256& h, const std::string& v)
+    : header(hdr), hash(h), validator(v) {}
 
 BlockPos::~BlockPos() {}
 
-std::string BlockPos::getHash() const {
+Hash256 BlockPos::getHash() const {
     return hash;
 }
 
-std::string BlockPos::getPreviousHash() const {
-    return previousHash;
+Hash256 BlockPos::getPreviousHash() const {
+    return header.previousHash;
 }
 
 int BlockPos::getIndex() const {
-    return index;
+    return static_cast<int>(header.height);
 }
 
-std::string BlockPos::calculateHash() const {
-    std::stringstream ss;
-    ss << index << getCurrentTime() << data << previousHash << validator;
-    return sha256(ss.str());
+int64_t BlockPos::getTimestamp() const {
+    return header.timestamp;
+}
+
+Hash256 BlockPos::calculateHash() const {
+    return ProofOfStake::sealHash(header, validator);
 }
 
 void BlockPos::display() const {
-    std::cout << "\n--- Block #" << index << " (PoS) ---" << std::endl;
-    std::cout << "Timestamp: " << getCurrentTime() << std::endl;
-    std::cout << "Data: " << data << std::endl;
+    std::cout << "\n--- Block #" << header.height << " (PoS) ---" << std::endl;
+    std::cout << "Timestamp: " << formatTimestamp(header.timestamp) << std::endl;
+    std::cout << "Merkle Root: " << header.merkleRoot.toHex().substr(0, 16) << "..." << std::endl;
     std::cout << "Validator: " << validator << std::endl;
-    std::cout << "Previous Hash: " << previousHash.substr(0, 16) << "..." << std::endl;
-    std::cout << "Hash: " << hash.substr(0, 16) << "..." << std::endl;
+    std::cout << "State Root: " << header.stateRoot.toHex().substr(0, 16) << "..." << std::endl;
+    std::cout << "Previous Hash: " << header.previousHash.toHex().substr(0, 16) << "..." << std::endl;
+    std::cout << "Hash: " << hash.toHex().substr(0, 16) << "..." << std::endl;
 }
 
-std::string BlockPos::getData() const {
-    return data;
+Hash256 BlockPos::getMerkleRoot() const {
+    return header.merkleRoot;
 }
 
 std::string BlockPos::getValidator() const {
     return validator;
+}
+
+const BlockHeader& BlockPos::getHeader() const {
+    return header;
+}
+
+Hash256 BlockPos::getStateRoot() const {
+    return header.stateRoot;
 }
\ No newline at end of file
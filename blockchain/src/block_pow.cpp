@@ -2,49 +2,58 @@
 #include "utils.h"
 #include "pow.h"
 #include <iostream>
-#include <sstream>
 
-BlockPow::BlockPow(int idx, const std::string& prevHash, const std::string& h, const std::string& d, int n, int diff)
-    : index(idx), previousHash(prevHash), hash(h), data(d), nonce(n), difficulty(diff) {}
+BlockPow::BlockPow(const BlockHeader& hdr, const Hash256& h) : header(hdr), hash(h) {}
 
 BlockPow::~BlockPow() {}
 
-std::string BlockPow::getHash() const {
+Hash256 BlockPow::getHash() const {
     return hash;
 }
 
-std::string BlockPow::getPreviousHash() const {
-    return previousHash;
+Hash256 BlockPow::getPreviousHash() const {
+    return header.previousHash;
 }
 
 int BlockPow::getIndex() const {
-    return index;
+    return static_cast<int>(header.height);
 }
 
-std::string BlockPow::calculateHash() const {
-    std::stringstream ss;
-    ss << index << getCurrentTime() << data << previousHash << nonce;
-    return sha256(ss.str());
+int64_t BlockPow::getTimestamp() const {
+    return header.timestamp;
+}
+
+Hash256 BlockPow::calculateHash() const {
+    return header.hash();
 }
 
 void BlockPow::display() const {
-    std::cout << "\n--- Block #" << index << " (PoW) ---" << std::endl;
-    std::cout << "Timestamp: " << getCurrentTime() << std::endl;
-    std::cout << "Data: " << data << std::endl;
-    std::cout << "Previous Hash: " << previousHash.substr(0, 16) << "..." << std::endl;
-    std::cout << "Hash: " << hash.substr(0, 16) << "..." << std::endl;
-    std::cout << "Nonce: " << nonce << std::endl;
-    std::cout << "Difficulty: " << difficulty << std::endl;
+    Hash256 target = getTarget();
+    std::cout << "\n--- Block #" << header.height << " (PoW) ---" << std::endl;
+    std::cout << "Timestamp: " << formatTimestamp(header.timestamp) << std::endl;
+    std::cout << "Merkle Root: " << header.merkleRoot.toHex().substr(0, 16) << "..." << std::endl;
+    std::cout << "Previous Hash: " << header.previousHash.toHex().substr(0, 16) << "..." << std::endl;
+    std::cout << "Hash: " << hash.toHex().substr(0, 16) << "..." << std::endl;
+    std::cout << "Nonce: " << header.nonce << " (extra " << header.extraNonce << ")" << std::endl;
+    std::cout << "Target: " << target.toHex().substr(0, 16) << "... (" << ProofOfWork::leadingZeroBits(target) << " zero bits)" << std::endl;
+}
+
+Hash256 BlockPow::getMerkleRoot() const {
+    return header.merkleRoot;
+}
+
+uint64_t BlockPow::getNonce() const {
+    return header.nonce;
 }
 
-std::string BlockPow::getData() const {
-    return data;
+uint32_t BlockPow::getExtraNonce() const {
+    return header.extraNonce;
 }
 
-int BlockPow::getNonce() const {
-    return nonce;
+Hash256 BlockPow::getTarget() const {
+    return ProofOfWork::targetFromCompact(header.bits);
 }
 
-int BlockPow::getDifficulty() const {
-    return difficulty;
+const BlockHeader& BlockPow::getHeader() const {
+    return header;
 }
\ No newline at end of file
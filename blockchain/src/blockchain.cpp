@@ -16,7 +16,7 @@ bool Blockchain::isChainValid() const {
     for (size_t i = 1; i < chain.size(); i++) {
         if (chain[i] == nullptr) continue;
         if (chain[i]->getHash() != chain[i]->calculateHash()) return false;
-        if (chain[i]->getPreviousHash() != chain[i-1]->getHash()) return false;
+        if (chain[i-1] && chain[i]->getPreviousHash() != chain[i-1]->getHash()) return false;
     }
     return true;
 }
@@ -31,6 +31,18 @@ void Blockchain::setDifficulty(int diff) {
     difficulty = diff;
 }
 
-std::string Blockchain::getLatestHash() const {
-    return chain.empty() ? "0" : chain.back()->getHash();
+Hash256 Blockchain::getLatestHash() const {
+    return chain.empty() ? Hash256() : chain.back()->getHash();
+}
+
+Hash256 Blockchain::getHistoryRoot() const {
+    return history.getRootHash();
+}
+
+MmrProof Blockchain::getAncestryProof(uint64_t height) const {
+    return history.getProof(height);
+}
+
+MmrProof Blockchain::getAncestryProof(uint64_t height, uint64_t tip) const {
+    return history.getProof(height, tip);
 }
\ No newline at end of file
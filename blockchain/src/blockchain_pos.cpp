@@ -4,12 +4,17 @@
 #include <iostream>
 #include <chrono>
 
-BlockchainPos::BlockchainPos(int diff, const std::vector<Validator>& vals) : Blockchain(diff) {
-    validators = vals;
-    std::string genesisData = "Genesis Block";
+BlockchainPos::BlockchainPos(int diff, const std::vector<Validator>& vals, size_t epochLen)
+    : Blockchain(diff), epochLength(epochLen ? epochLen : 1) {
+    stakes.assign(vals);
+    commitStakes(std::vector<Hash256>());
+    BlockHeader header = makeHeader(MerkleTree({"Genesis Block"}).getRootHash());
+    epochStakes.push_back(StakeSnapshot::of(stakes));
     std::string selectedValidator = "GenesisValidator";
-    std::string genesisHash = ProofOfStake::validateBlock(genesisData, "0", validators, selectedValidator);
-    chain.push_back(new BlockPos(0, "0", genesisHash, genesisData, selectedValidator));
+    Hash256 genesisHash = ProofOfStake::validateBlock(header, scheduleFor(header.height), selectedValidator);
+    chain.push_back(new BlockPos(header, genesisHash, selectedValidator));
+    history.append(genesisHash);
+    recordBoundary(header.height);
 }
 
 BlockchainPos::~BlockchainPos() {
@@ -20,23 +25,46 @@ BlockchainPos::~BlockchainPos() {
 
 void BlockchainPos::addBlock(const std::vector<std::string>& transactions) {
     MerkleTree merkleTree(transactions);
-    std::string merkleRoot = merkleTree.getRootHash();
-    std::string prevHash = getLatestHash();
+    BlockHeader header = makeHeader(merkleTree.getRootHash());
     std::string selectedValidator;
     auto start = std::chrono::high_resolution_clock::now();
-    std::string newHash = ProofOfStake::validateBlock(merkleRoot, prevHash, validators, selectedValidator);
+    Hash256 newHash = ProofOfStake::validateBlock(header, scheduleFor(header.height), selectedValidator);
     auto end = std::chrono::high_resolution_clock::now();
     long long duration = measureTime([&]() {});
-    chain.push_back(new BlockPos(chain.size(), prevHash, newHash, merkleRoot, selectedValidator));
+    chain.push_back(new BlockPos(header, newHash, selectedValidator));
+    history.append(newHash);
+    recordBoundary(header.height);
     std::cout << "Block #" << chain.size() - 1 << " validated by " << selectedValidator << " in " << duration << " ms" << std::endl;
 }
 
 bool BlockchainPos::isChainValid() const {
+    // Replays the history commitment: each header must carry the root over
+    // the blocks before it.
+    MerkleMountainRange replay;
+    if (!chain.empty()) {
+        if (!chain[0]->getHeader().historyRoot.empty()) return false;
+        replay.append(chain[0]->getHash());
+    }
+    ProposerSchedule schedule;
     for (size_t i = 1; i < chain.size(); i++) {
-        if (!ProofOfStake::verifyBlock(chain[i]->getData(), chain[i]->getPreviousHash(), chain[i]->getHash(), chain[i]->getValidator())) {
+        if (chain[i]->getHeader().historyRoot != replay.getRootHash()) return false;
+        replay.append(chain[i]->getHash());
+        if (!ProofOfStake::verifyBlock(chain[i]->getHeader(), chain[i]->getHash(), chain[i]->getValidator())) {
             return false;
         }
         if (chain[i]->getPreviousHash() != chain[i-1]->getHash()) return false;
+        // The block's proposer must be the one its epoch schedules, rebuilt
+        // from the boundary block: its hash seeds the draws and its state
+        // root commits to the stakes they are drawn from.
+        if (i == 1 || i % epochLength == 0) {
+            size_t epoch = i / epochLength;
+            if (epoch >= epochStakes.size()) return false;
+            const BlockPos* boundary = epoch == 0 ? chain[0] : chain[epoch * epochLength - 1];
+            if (!verifyStakeSnapshot(epochStakes[epoch], boundary->getStateRoot())) return false;
+            Hash256 seed = epoch == 0 ? Hash256() : boundary->getHash();
+            schedule = ProposerSchedule::build(seed, epoch * epochLength, epochLength, epochStakes[epoch].toIndex());
+        }
+        if (!schedule.empty() && chain[i]->getValidator() != schedule.proposerAt(i)) return false;
     }
     return true;
 }
@@ -51,10 +79,134 @@ void BlockchainPos::setDifficulty(int diff) {
     difficulty = diff;
 }
 
-std::string BlockchainPos::getLatestHash() const {
-    return chain.empty() ? "0" : chain.back()->getHash();
+BlockHeader BlockchainPos::makeHeader(const Hash256& merkleRoot) const {
+    BlockHeader header;
+    header.height = static_cast<uint32_t>(chain.size());
+    header.previousHash = getLatestHash();
+    header.merkleRoot = merkleRoot;
+    header.historyRoot = history.getRootHash();
+    header.stateRoot = stakeState.getRootHash();
+    header.timestamp = currentTimestamp();
+    return header;
+}
+
+// Schedules the epoch containing `slot` on first use; only called for the
+// next block, so a new epoch is always scheduled on top of the current tip.
+const ProposerSchedule& BlockchainPos::scheduleFor(uint64_t slot) {
+    size_t epoch = slot / epochLength;
+    if (epoch == schedules.size()) {
+        schedules.push_back(ProposerSchedule::build(getLatestHash(), epoch * epochLength, epochLength, epochStakes[epoch].toIndex()));
+    }
+    return schedules[epoch];
+}
+
+// Block `height` closes its epoch when it is the last slot; the stakes it
+// commits to are the next epoch's.
+void BlockchainPos::recordBoundary(uint64_t height) {
+    if ((height + 1) % epochLength == 0) epochStakes.push_back(StakeSnapshot::of(stakes));
+}
+
+const StakeSnapshot& BlockchainPos::getEpochStakes(size_t epoch) const {
+    return epochStakes.at(epoch);
+}
+
+bool BlockchainPos::verifyStakeSnapshot(const StakeSnapshot& snapshot, const Hash256& stateRoot) {
+    if (snapshot.ids.size() != snapshot.stakes.size()) return false;
+    SparseMerkleTree state;
+    std::vector<std::pair<Hash256, Hash256>> leaves;
+    leaves.reserve(snapshot.ids.size());
+    for (size_t i = 0; i < snapshot.ids.size(); i++) {
+        Hash256 key = SparseMerkleTree::keyFor(snapshot.ids[i]);
+        // Strictly increasing keys: one order per state, no repeated ids.
+        if (i > 0 && !(leaves.back().first < key)) return false;
+        leaves.push_back(std::make_pair(key, stakeValue(snapshot.ids[i], snapshot.stakes[i])));
+    }
+    state.update(leaves);
+    return state.getRootHash() == stateRoot;
+}
+
+size_t BlockchainPos::getEpochLength() const {
+    return epochLength;
+}
+
+std::string BlockchainPos::getProposer(uint64_t slot) const {
+    size_t epoch = slot / epochLength;
+    if (epoch >= schedules.size() || schedules[epoch].empty()) return std::string();
+    return schedules[epoch].proposerAt(slot);
+}
+
+Hash256 BlockchainPos::getLatestHash() const {
+    return chain.empty() ? Hash256() : chain.back()->getHash();
+}
+
+const BlockHeader& BlockchainPos::getHeader(uint64_t height) const {
+    return chain.at(height)->getHeader();
 }
 
 void BlockchainPos::setValidators(const std::vector<Validator>& vals) {
-    validators = vals;
+    std::vector<Hash256> previous;
+    previous.reserve(stakes.size());
+    for (size_t i = 0; i < stakes.size(); i++) previous.push_back(SparseMerkleTree::keyFor(stakes.idAt(i)));
+    stakes.assign(vals);
+    commitStakes(previous);
+}
+
+std::vector<Validator> BlockchainPos::getValidators() const {
+    return stakes.toValidators();
+}
+
+// Applies the switch from the `previous` keys to the current validators as
+// one batch: dropped validators are removed, the rest (re)written.
+void BlockchainPos::commitStakes(const std::vector<Hash256>& previous) {
+    const ValidatorRegistry& registry = stakes.getRegistry();
+    std::vector<std::pair<Hash256, Hash256>> updates;
+    updates.reserve(previous.size() + registry.size());
+    for (const auto& key : previous) updates.push_back(std::make_pair(key, Hash256()));
+    for (size_t i = 0; i < registry.size(); i++) {
+        const std::string& id = registry.idAt(i);
+        updates.push_back(std::make_pair(SparseMerkleTree::keyFor(id), stakeValue(id, registry.stakeAt(i))));
+    }
+    stakeState.update(updates);
+}
+
+void BlockchainPos::commitStake(const std::string& validatorId) {
+    stakeState.update(SparseMerkleTree::keyFor(validatorId), stakeValue(validatorId, stakes.stakeOf(validatorId)));
+}
+
+void BlockchainPos::deposit(const std::string& validatorId, uint64_t amount) {
+    stakes.deposit(validatorId, amount);
+    commitStake(validatorId);
+}
+
+void BlockchainPos::withdraw(const std::string& validatorId, uint64_t amount) {
+    stakes.withdraw(validatorId, amount);
+    commitStake(validatorId);
+}
+
+uint64_t BlockchainPos::slash(const std::string& validatorId, uint64_t amount) {
+    uint64_t taken = stakes.slash(validatorId, amount);
+    commitStake(validatorId);
+    return taken;
+}
+
+uint64_t BlockchainPos::getStake(const std::string& validatorId) const {
+    return stakes.contains(validatorId) ? stakes.stakeOf(validatorId) : 0;
+}
+
+Hash256 BlockchainPos::stakeValue(const Validator& validator) {
+    return stakeValue(validator.id, validator.stake > 0 ? static_cast<uint64_t>(validator.stake) : 0);
+}
+
+Hash256 BlockchainPos::stakeValue(const std::string& validatorId, uint64_t stake) {
+    Sha256Hasher hasher;
+    hasher.update(validatorId).updateUint64(stake);
+    return hasher.finalize();
+}
+
+Hash256 BlockchainPos::getStateRoot() const {
+    return stakeState.getRootHash();
+}
+
+SparseMerkleProof BlockchainPos::getStakeProof(const std::string& validatorId) const {
+    return stakeState.getProof(SparseMerkleTree::keyFor(validatorId));
 }
\ No newline at end of file
@@ -4,14 +4,24 @@
 #include <iostream>
 #include <chrono>
 
+// One link of the target schedule commitment: absorbs the previous root, the
+// change's height and its bits.
+static Hash256 extendSchedule(const Hash256& root, const std::pair<uint64_t, uint32_t>& change) {
+    return Sha256Hasher().update(root).updateUint64(change.first).updateUint32(change.second).finalize();
+}
+
 BlockchainPow::BlockchainPow(int diff) : Blockchain(diff) {
-    std::string genesisData = "Genesis Block";
-    int nonce = 0;
-    std::string genesisHash = ProofOfWork::mineBlock(genesisData, "0", difficulty, nonce);
-    chain.push_back(new BlockPow(0, "0", genesisHash, genesisData, nonce, difficulty));
+    setDifficulty(diff);
+    BlockHeader header = makeHeader(MerkleTree({"Genesis Block"}).getRootHash());
+    Hash256 genesisHash = ProofOfWork::mineBlock(header);
+    chain.push_back(new BlockPow(header, genesisHash));
+    history.append(genesisHash);
 }
 
 BlockchainPow::~BlockchainPow() {
+    for (auto& pending : pendingJobs) {
+        if (auto job = pending.lock()) job->cancelFlag.store(true);
+    }
     for (auto* block : chain) {
         delete block;
     }
@@ -19,20 +29,126 @@ BlockchainPow::~BlockchainPow() {
 
 void BlockchainPow::addBlock(const std::vector<std::string>& transactions) {
     MerkleTree merkleTree(transactions);
-    std::string merkleRoot = merkleTree.getRootHash();
-    std::string prevHash = getLatestHash();
-    int nonce = 0;
+    BlockHeader header = makeHeader(merkleTree.getRootHash());
     auto start = std::chrono::high_resolution_clock::now();
-    std::string newHash = ProofOfWork::mineBlock(merkleRoot, prevHash, difficulty, nonce);
+    Hash256 newHash = ProofOfWork::mineBlock(header, miningOptions);
     auto end = std::chrono::high_resolution_clock::now();
     long long duration = measureTime([&]() {});
-    chain.push_back(new BlockPow(chain.size(), prevHash, newHash, merkleRoot, nonce, difficulty));
+    appendBlock(new BlockPow(header, newHash));
     std::cout << "Block #" << chain.size() - 1 << " mined in " << duration << " ms" << std::endl;
 }
 
+MiningHandle BlockchainPow::submitMiningJob(const std::vector<std::string>& transactions,
+                                            const std::function<void(const MiningProgress&)>& onProgress) {
+    MerkleTree merkleTree(transactions);
+    std::shared_ptr<MiningJob> job(new MiningJob(makeHeader(merkleTree.getRootHash()), miningOptions));
+    pendingJobs.push_back(job);
+    return startMiningJob(job, onProgress);
+}
+
+bool BlockchainPow::commitMiningJob(const MiningHandle& handle) {
+    std::shared_ptr<MiningJob> job = handle.getJob();
+    if (!job) return false;
+    MiningResult result;
+    try {
+        result = handle.get();
+    } catch (const MiningCancelled&) {
+        return false;
+    }
+    // A job cancelled after it already found a nonce is still dropped.
+    if (job->cancelFlag.load() || job->header.previousHash != getLatestHash() ||
+        job->header.stateRoot != scheduleRoot(job->header.height)) {
+        return false;
+    }
+    BlockHeader header = job->header;
+    header.nonce = result.nonce;
+    header.extraNonce = result.extraNonce;
+    appendBlock(new BlockPow(header, result.hash));
+    std::cout << "Block #" << chain.size() - 1 << " mined in background" << std::endl;
+    return true;
+}
+
+BlockHeader BlockchainPow::makeHeader(const Hash256& merkleRoot) const {
+    BlockHeader header;
+    header.height = static_cast<uint32_t>(chain.size());
+    header.previousHash = getLatestHash();
+    header.merkleRoot = merkleRoot;
+    header.historyRoot = history.getRootHash();
+    header.timestamp = currentTimestamp();
+    header.bits = requiredBits(header.height);
+    header.stateRoot = scheduleRoot(header.height);
+    return header;
+}
+
+uint32_t BlockchainPow::requiredBits(uint64_t height) const {
+    size_t i = targetChanges.size();
+    while (i > 0 && targetChanges[i - 1].first > height) i--;
+    return i > 0 ? targetChanges[i - 1].second : 0;
+}
+
+Hash256 BlockchainPow::scheduleRoot(uint64_t height) const {
+    return commitTargetChanges(targetChanges, height);
+}
+
+// Hash chain over the changes in force by `height`.
+Hash256 BlockchainPow::commitTargetChanges(const std::vector<std::pair<uint64_t, uint32_t>>& changes, uint64_t height) {
+    Hash256 root;
+    for (const auto& change : changes) {
+        if (change.first > height) break;
+        root = extendSchedule(root, change);
+    }
+    return root;
+}
+
+void BlockchainPow::appendBlock(BlockPow* block) {
+    chain.push_back(block);
+    history.append(block->getHash());
+    cancelStaleJobs();
+}
+
+// Jobs built on an older tip or target can no longer produce a block we
+// would accept.
+void BlockchainPow::cancelStaleJobs() {
+    Hash256 tip = getLatestHash();
+    std::vector<std::weak_ptr<MiningJob>> stillPending;
+    for (auto& pending : pendingJobs) {
+        std::shared_ptr<MiningJob> job = pending.lock();
+        if (!job) continue;
+        if (job->header.previousHash != tip || job->header.stateRoot != scheduleRoot(job->header.height)) {
+            job->cancelFlag.store(true);
+        } else {
+            stillPending.push_back(pending);
+        }
+    }
+    pendingJobs.swap(stillPending);
+}
+
 bool BlockchainPow::isChainValid() const {
-    for (size_t i = 1; i < chain.size(); i++) {
-        if (!ProofOfWork::verifyBlock(chain[i]->getData(), chain[i]->getPreviousHash(), chain[i]->getHash(), chain[i]->getDifficulty(), chain[i]->getNonce())) {
+    // The target schedule starts at genesis and only records real changes.
+    if (targetChanges.empty() || targetChanges[0].first != 0) return false;
+    for (size_t c = 1; c < targetChanges.size(); c++) {
+        if (targetChanges[c].first <= targetChanges[c - 1].first) return false;
+        if (targetChanges[c].second == targetChanges[c - 1].second) return false;
+    }
+    // Replays the history commitment and the target schedule: each header
+    // must carry the root over the blocks before it, commit to the schedule
+    // up to its height, and carry the bits that schedule puts in force.
+    // verifyBlock then checks the hash against those bits.
+    MerkleMountainRange replay;
+    Hash256 schedule;
+    size_t nextChange = 0;
+    uint32_t bits = 0;
+    for (size_t i = 0; i < chain.size(); i++) {
+        const BlockHeader& header = chain[i]->getHeader();
+        while (nextChange < targetChanges.size() && targetChanges[nextChange].first <= i) {
+            schedule = extendSchedule(schedule, targetChanges[nextChange]);
+            bits = targetChanges[nextChange++].second;
+        }
+        if (header.stateRoot != schedule || header.bits != bits) return false;
+        if (header.historyRoot != replay.getRootHash()) return false;
+        replay.append(chain[i]->getHash());
+        if (i == 0) continue;
+        if (!ProofOfWork::verifyBlock(header, chain[i]->getHash())) {
             return false;
         }
         if (chain[i]->getPreviousHash() != chain[i-1]->getHash()) return false;
@@ -48,8 +164,43 @@ void BlockchainPow::displayChain() const {
 
 void BlockchainPow::setDifficulty(int diff) {
     difficulty = diff;
+    setTarget(ProofOfWork::targetFromZeroBits(4 * diff));
+}
+
+void BlockchainPow::setDifficultyBits(int bits) {
+    setTarget(ProofOfWork::targetFromZeroBits(bits));
+    difficulty = bits / 4;
+}
+
+void BlockchainPow::setTarget(const Hash256& t) {
+    // Headers carry the target in compact form, which keeps only its top
+    // 23 bits; round-trip it so mining and verification agree.
+    uint32_t bits = ProofOfWork::compactFromTarget(t);
+    target = ProofOfWork::targetFromCompact(bits);
+    difficulty = ProofOfWork::leadingZeroBits(target) / 4;
+    // The new target applies from the next block on. Only real changes are
+    // recorded, so setting the target in force again leaves the schedule
+    // (and its commitment) as it was.
+    uint64_t height = chain.size();
+    if (!targetChanges.empty() && targetChanges.back().first == height) targetChanges.pop_back();
+    if (targetChanges.empty() || targetChanges.back().second != bits) {
+        targetChanges.push_back(std::make_pair(height, bits));
+    }
+    cancelStaleJobs();
+}
+
+void BlockchainPow::setMiningOptions(const MiningOptions& options) {
+    miningOptions = options;
+}
+
+Hash256 BlockchainPow::getLatestHash() const {
+    return chain.empty() ? Hash256() : chain.back()->getHash();
+}
+
+const BlockHeader& BlockchainPow::getHeader(uint64_t height) const {
+    return chain.at(height)->getHeader();
 }
 
-std::string BlockchainPow::getLatestHash() const {
-    return chain.empty() ? "0" : chain.back()->getHash();
+const std::vector<std::pair<uint64_t, uint32_t>>& BlockchainPow::getTargetChanges() const {
+    return targetChanges;
 }
\ No newline at end of file
@@ -0,0 +1,40 @@
+#include "hash256.h"
+#include <stdexcept>
+
+bool Hash256::empty() const {
+    static const Hash256 zero;
+    return *this == zero;
+}
+
+std::string Hash256::toHex() const {
+    static const char digits[] = "0123456789abcdef";
+    std::string hex(SIZE * 2, '0');
+    for (size_t i = 0; i < SIZE; i++) {
+        hex[2 * i] = digits[bytes[i] >> 4];
+        hex[2 * i + 1] = digits[bytes[i] & 0x0f];
+    }
+    return hex;
+}
+
+static int hexValue(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+Hash256 Hash256::fromHex(const std::string& hex) {
+    if (hex.size() != SIZE * 2) {
+        throw std::invalid_argument("Hash256::fromHex expects 64 hex characters");
+    }
+    Hash256 h;
+    for (size_t i = 0; i < SIZE; i++) {
+        int hi = hexValue(hex[2 * i]);
+        int lo = hexValue(hex[2 * i + 1]);
+        if (hi < 0 || lo < 0) {
+            throw std::invalid_argument("Hash256::fromHex: invalid hex digit");
+        }
+        h.bytes[i] = static_cast<unsigned char>((hi << 4) | lo);
+    }
+    return h;
+}
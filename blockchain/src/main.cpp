@@ -15,7 +15,7 @@ int main() {
     std::vector<std::string> transactions1 = {"Tx1: Alice->Bob:50", "Tx2: Bob->Charlie:30"};
     MerkleTree merkleTree(transactions1);
     merkleTree.printTree();
-    std::cout << "Root Hash: " << merkleTree.getRootHash() << "\n\n";
+    std::cout << "Root Hash: " << merkleTree.getRootHash().toHex() << "\n\n";
 
     // Exercise 2: Proof of Work Demo
     std::cout << "=== Exercise 2: Proof of Work Demo ===\n";
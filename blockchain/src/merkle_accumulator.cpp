@@ -0,0 +1,142 @@
+#include "merkle_accumulator.h"
+#include "utils.h"
+#include "sha256.h"
+#include <cstring>
+#include <stdexcept>
+#ifdef _WIN32
+#include <fstream>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MerkleAccumulator::MerkleAccumulator() : leafCount(0) {}
+
+void MerkleAccumulator::append(const std::string& transaction) {
+    appendHash(sha256(transaction));
+}
+
+// Like a binary increment: every complete subtree the new leaf closes is
+// merged into its left neighbour and carried one height up.
+void MerkleAccumulator::appendHash(const Hash256& leafHash) {
+    Hash256 node = leafHash;
+    size_t height = 0;
+    while ((leafCount >> height) & 1) {
+        node = sha256(frontier[height], node);
+        height++;
+    }
+    if (height == frontier.size()) frontier.push_back(node);
+    else frontier[height] = node;
+    leafCount++;
+}
+
+size_t MerkleAccumulator::size() const {
+    return leafCount;
+}
+
+// Walks up from the lowest complete subtree, which is the last node of its
+// level. Above it, the last node of level h is a right child exactly when bit
+// h of the leaf count is set (its left sibling is frontier[h]); otherwise it
+// is an odd level's last node and is paired with itself.
+Hash256 MerkleAccumulator::getRootHash() const {
+    if (leafCount == 0) return Hash256();
+    size_t height = 0;
+    while (!((leafCount >> height) & 1)) height++;
+    Hash256 node = frontier[height];
+    if ((leafCount >> height) == 1) return node;
+    node = sha256(node, node);
+    for (height++; (leafCount >> height) != 0; height++) {
+        node = ((leafCount >> height) & 1) ? sha256(frontier[height], node) : sha256(node, node);
+    }
+    return node;
+}
+
+void MerkleAccumulator::clear() {
+    frontier.clear();
+    leafCount = 0;
+}
+
+// Leaves are hashed this many at a time so the batch kernels stay busy while
+// the pending input stays small.
+static const size_t STREAM_BATCH = 1024;
+
+void MerkleAccumulator::appendBatch(const unsigned char* const* transactions, const size_t* lengths, size_t count) {
+    if (count == 0) return;
+    Hash256 digests[STREAM_BATCH];
+    sha256_batch(transactions, lengths, count, digests);
+    for (size_t i = 0; i < count; i++) appendHash(digests[i]);
+}
+
+size_t MerkleAccumulator::appendLines(std::istream& in) {
+    std::vector<std::string> lines(STREAM_BATCH);
+    const unsigned char* pointers[STREAM_BATCH];
+    size_t lengths[STREAM_BATCH];
+    size_t total = 0;
+    for (;;) {
+        size_t count = 0;
+        while (count < STREAM_BATCH && std::getline(in, lines[count])) {
+            pointers[count] = reinterpret_cast<const unsigned char*>(lines[count].data());
+            lengths[count] = lines[count].size();
+            count++;
+        }
+        if (count == 0) break;
+        appendBatch(pointers, lengths, count);
+        total += count;
+        if (count < STREAM_BATCH) break;
+    }
+    return total;
+}
+
+#ifdef _WIN32
+size_t MerkleAccumulator::appendFile(const std::string& path) {
+    std::ifstream in(path.c_str(), std::ios::binary);
+    if (!in) throw std::runtime_error("MerkleAccumulator::appendFile: cannot open " + path);
+    return appendLines(in);
+}
+#else
+// The mapping is read front to back once; lines are hashed straight out of
+// the page cache without copying.
+size_t MerkleAccumulator::appendFile(const std::string& path) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) throw std::runtime_error("MerkleAccumulator::appendFile: cannot open " + path);
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        close(fd);
+        throw std::runtime_error("MerkleAccumulator::appendFile: cannot stat " + path);
+    }
+    size_t fileSize = static_cast<size_t>(info.st_size);
+    if (fileSize == 0) {
+        close(fd);
+        return 0;
+    }
+    void* mapping = mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) throw std::runtime_error("MerkleAccumulator::appendFile: cannot map " + path);
+    madvise(mapping, fileSize, MADV_SEQUENTIAL);
+
+    const unsigned char* data = static_cast<const unsigned char*>(mapping);
+    const unsigned char* end = data + fileSize;
+    const unsigned char* pointers[STREAM_BATCH];
+    size_t lengths[STREAM_BATCH];
+    size_t count = 0;
+    size_t total = 0;
+    while (data < end) {
+        const unsigned char* newline = static_cast<const unsigned char*>(std::memchr(data, '\n', end - data));
+        const unsigned char* lineEnd = newline ? newline : end;
+        pointers[count] = data;
+        lengths[count] = lineEnd - data;
+        if (++count == STREAM_BATCH) {
+            appendBatch(pointers, lengths, count);
+            total += count;
+            count = 0;
+        }
+        data = newline ? newline + 1 : end;
+    }
+    appendBatch(pointers, lengths, count);
+    total += count;
+    munmap(mapping, fileSize);
+    return total;
+}
+#endif
\ No newline at end of file
@@ -0,0 +1,114 @@
+#include "merkle_levels.h"
+#include "sha256.h"
+#include "utils.h"
+#include <algorithm>
+#include <cstring>
+
+static_assert(sizeof(Hash256) == Hash256::SIZE, "MerkleLevels hashes sibling digests in place");
+
+const size_t MerkleLevels::MIN_PARALLEL_CHUNK;
+
+MerkleLevels::MerkleLevels(size_t a) : arity(a < 2 ? 2 : a) {}
+
+void MerkleLevels::build(const std::vector<std::string>& transactions, ThreadPool& pool) {
+    nodes.clear();
+    levelOffsets.clear();
+    if (transactions.empty()) return;
+    // Size every level up front so the whole tree is a single allocation.
+    levelOffsets.push_back(0);
+    for (size_t width = transactions.size(); ; width = (width + arity - 1) / arity) {
+        levelOffsets.push_back(levelOffsets.back() + width);
+        if (width == 1) break;
+    }
+    nodes.resize(levelOffsets.back());
+
+    std::vector<const unsigned char*> inputs(transactions.size());
+    std::vector<size_t> lengths(transactions.size());
+    pool.parallelFor(transactions.size(), MIN_PARALLEL_CHUNK, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            inputs[i] = reinterpret_cast<const unsigned char*>(transactions[i].data());
+            lengths[i] = transactions[i].size();
+        }
+        sha256_batch(&inputs[begin], &lengths[begin], end - begin, &nodes[begin]);
+    });
+
+    // Siblings are adjacent in the buffer, so each full group is read in
+    // place; only a level's last, short group is copied out and padded.
+    const size_t groupBytes = arity * Hash256::SIZE;
+    std::vector<unsigned char> lastGroup(groupBytes);
+    for (size_t level = 0; level + 2 < levelOffsets.size(); level++) {
+        size_t width = getLevelSize(level);
+        const Hash256* children = &nodes[levelOffsets[level]];
+        size_t parentCount = (width + arity - 1) / arity;
+        for (size_t p = 0; p < width / arity; p++) {
+            inputs[p] = children[p * arity].data();
+        }
+        if (width % arity) {
+            for (size_t c = 0; c < arity; c++) {
+                size_t child = std::min<size_t>(parentCount * arity - arity + c, width - 1);
+                std::memcpy(&lastGroup[c * Hash256::SIZE], children[child].data(), Hash256::SIZE);
+            }
+            inputs[parentCount - 1] = lastGroup.data();
+        }
+        Hash256* parents = &nodes[levelOffsets[level + 1]];
+        pool.parallelFor(parentCount, MIN_PARALLEL_CHUNK, [&](size_t begin, size_t end) {
+            sha256_batch(&inputs[begin], groupBytes, end - begin, parents + begin);
+        });
+    }
+}
+
+size_t MerkleLevels::getArity() const {
+    return arity;
+}
+
+Hash256 MerkleLevels::getRootHash() const {
+    return nodes.empty() ? Hash256() : nodes.back();
+}
+
+size_t MerkleLevels::getLeafCount() const {
+    return getLevelCount() ? getLevelSize(0) : 0;
+}
+
+size_t MerkleLevels::getLevelCount() const {
+    return levelOffsets.empty() ? 0 : levelOffsets.size() - 1;
+}
+
+size_t MerkleLevels::getLevelSize(size_t level) const {
+    return levelOffsets[level + 1] - levelOffsets[level];
+}
+
+const Hash256& MerkleLevels::getNode(size_t level, size_t index) const {
+    return nodes[levelOffsets[level] + index];
+}
+
+std::vector<Hash256> MerkleLevels::getPath(size_t txIndex) const {
+    std::vector<Hash256> siblings;
+    size_t index = txIndex;
+    for (size_t level = 0; level + 1 < getLevelCount(); level++) {
+        size_t first = index - index % arity;
+        for (size_t c = 0; c < arity; c++) {
+            if (first + c == index) continue;
+            // Members past the end of the level are padding copies of its last node.
+            siblings.push_back(getNode(level, std::min<size_t>(first + c, getLevelSize(level) - 1)));
+        }
+        index /= arity;
+    }
+    return siblings;
+}
+
+bool MerkleLevels::verifyPath(const Hash256& leafHash, size_t index, const std::vector<Hash256>& siblings,
+                              size_t arity, const Hash256& rootHash) {
+    if (arity < 2 || siblings.size() % (arity - 1)) return false;
+    Hash256 hash = leafHash;
+    std::vector<unsigned char> group(arity * Hash256::SIZE);
+    for (size_t s = 0; s < siblings.size(); s += arity - 1) {
+        size_t slot = index % arity;
+        for (size_t c = 0, k = s; c < arity; c++) {
+            const Hash256& member = c == slot ? hash : siblings[k++];
+            std::memcpy(&group[c * Hash256::SIZE], member.data(), Hash256::SIZE);
+        }
+        hash = sha256(group.data(), group.size());
+        index /= arity;
+    }
+    return index == 0 && hash == rootHash;
+}
\ No newline at end of file
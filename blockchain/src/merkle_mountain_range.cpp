@@ -0,0 +1,102 @@
+#include "merkle_mountain_range.h"
+#include "utils.h"
+#include <stdexcept>
+#include <string>
+
+void MerkleMountainRange::append(const Hash256& leaf) {
+    Hash256 node = leaf;
+    for (size_t height = 0; ; height++) {
+        if (height == nodes.size()) nodes.push_back(std::vector<Hash256>());
+        std::vector<Hash256>& level = nodes[height];
+        level.push_back(node);
+        // An odd count means the new node has no left partner yet.
+        if (level.size() % 2) break;
+        node = sha256(level[level.size() - 2], level.back());
+    }
+}
+
+uint64_t MerkleMountainRange::size() const {
+    return nodes.empty() ? 0 : nodes[0].size();
+}
+
+std::vector<Hash256> MerkleMountainRange::getPeaks() const {
+    return getPeaks(size());
+}
+
+// After leafCount appends, level h held its first leafCount >> h nodes, and
+// the last of them was a peak when that count was odd.
+std::vector<Hash256> MerkleMountainRange::getPeaks(uint64_t leafCount) const {
+    if (leafCount > size()) {
+        throw std::out_of_range("MerkleMountainRange::getPeaks: only " + std::to_string(size()) + " leaves");
+    }
+    std::vector<Hash256> peaks;
+    for (size_t height = nodes.size(); height-- > 0;) {
+        uint64_t count = leafCount >> height;
+        if (count % 2) peaks.push_back(nodes[height][count - 1]);
+    }
+    return peaks;
+}
+
+Hash256 MerkleMountainRange::bagPeaks(uint64_t leafCount, const std::vector<Hash256>& peaks) {
+    Sha256Hasher hasher;
+    hasher.updateUint64(leafCount);
+    for (const auto& peak : peaks) hasher.update(peak);
+    return hasher.finalize();
+}
+
+Hash256 MerkleMountainRange::getRootHash() const {
+    return getRootHash(size());
+}
+
+Hash256 MerkleMountainRange::getRootHash(uint64_t leafCount) const {
+    if (leafCount == 0) return Hash256();
+    return bagPeaks(leafCount, getPeaks(leafCount));
+}
+
+MmrProof MerkleMountainRange::getProof(uint64_t leafIndex) const {
+    return getProof(leafIndex, size());
+}
+
+MmrProof MerkleMountainRange::getProof(uint64_t leafIndex, uint64_t leafCount) const {
+    if (leafIndex >= leafCount || leafCount > size()) {
+        throw std::out_of_range("MerkleMountainRange::getProof: no leaf " + std::to_string(leafIndex) +
+                                " among " + std::to_string(leafCount));
+    }
+    MmrProof proof;
+    proof.leafIndex = leafIndex;
+    proof.leafCount = leafCount;
+    // A node has a parent exactly when its sibling exists; the first node
+    // without one is the peak of the leaf's mountain.
+    uint64_t position = leafIndex;
+    for (size_t height = 0; (position ^ 1) < (leafCount >> height); height++) {
+        proof.siblings.push_back(nodes[height][position ^ 1]);
+        position >>= 1;
+    }
+    proof.peaks = getPeaks(leafCount);
+    return proof;
+}
+
+bool MerkleMountainRange::verifyProof(const Hash256& leaf, const MmrProof& proof, const Hash256& rootHash) {
+    if (proof.leafIndex >= proof.leafCount) return false;
+    // Mountains cover consecutive leaf ranges, tallest first; find the one
+    // holding leafIndex and its position among the peaks.
+    uint64_t start = 0;
+    size_t peak = 0;
+    int height = 63;
+    for (; height >= 0; height--) {
+        uint64_t width = uint64_t(1) << height;
+        if (!(proof.leafCount & width)) continue;
+        if (proof.leafIndex < start + width) break;
+        start += width;
+        peak++;
+    }
+    if (height < 0 || proof.siblings.size() != static_cast<size_t>(height) || peak >= proof.peaks.size()) return false;
+
+    Hash256 node = leaf;
+    uint64_t position = proof.leafIndex - start;
+    for (const auto& sibling : proof.siblings) {
+        node = (position & 1) ? sha256(sibling, node) : sha256(node, sibling);
+        position >>= 1;
+    }
+    return node == proof.peaks[peak] && bagPeaks(proof.leafCount, proof.peaks) == rootHash;
+}
\ No newline at end of file
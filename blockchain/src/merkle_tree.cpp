@@ -1,103 +1,174 @@
 #include "merkle_tree.h"
 #include "utils.h"
 #include <iostream>
-#include <sstream>
-#include <iomanip>
-
-MerkleNode::MerkleNode(const std::string& data) {
-    this->hash = sha256(data);
-    this->left = nullptr;
-    this->right = nullptr;
-}
-
-MerkleNode::MerkleNode(MerkleNode* l, MerkleNode* r) {
-    this->left = l;
-    this->right = r;
-    std::string combined = l->hash + r->hash;
-    this->hash = sha256(combined);
-}
-
-MerkleNode::~MerkleNode() {
-    MerkleNode* l = left;
-    MerkleNode* r = right;
-    //avoid double-delete when both child pointers point to the same node
-    // could be solved using unique_ptr instead of regular pointers
-    if (l && r && l == r) {
-        // both pointers point to the same child, delete it only once
-        delete l;
-    } else {
-        if (l) delete l;
-        if (r) delete r;
-    }
-    left = nullptr;
-    right = nullptr;
+#include <algorithm>
+#include <stdexcept>
+
+const size_t MerkleTree::MIN_PARALLEL_CHUNK;
+
+MerkleTree::MerkleTree(const std::vector<std::string>& transactions) : levels(2) {
+    levels.build(transactions, ThreadPool::shared());
 }
 
-MerkleTree::MerkleTree(const std::vector<std::string>& transactions) {
-    if (transactions.empty()) {
-        root = nullptr;
-        return;
-    }
+MerkleTree::MerkleTree(const std::vector<std::string>& transactions, ThreadPool& pool) : levels(2) {
+    levels.build(transactions, pool);
+}
 
-    std::vector<MerkleNode*> leafNodes;
-    for (const auto& tx : transactions) {
-        leafNodes.push_back(new MerkleNode(tx));
-    }
-    root = buildTreeRecursive(leafNodes);
+Hash256 MerkleTree::getRootHash() const {
+    return levels.getRootHash();
 }
 
-MerkleNode* MerkleTree::buildTreeRecursive(std::vector<MerkleNode*>& nodes) {
-    if (nodes.size() == 1) {
-        return nodes[0];
-    }
-    std::vector<MerkleNode*> parentNodes;
-    for (size_t i = 0; i < nodes.size(); i += 2) {
-        MerkleNode* left = nodes[i];
-        MerkleNode* right = (i + 1 == nodes.size()) ? nodes[i] : nodes[i + 1];
-        MerkleNode* parent = new MerkleNode(left, right);
-        parentNodes.push_back(parent);
-    }
-    return buildTreeRecursive(parentNodes);
+size_t MerkleTree::getLeafCount() const {
+    return levels.getLeafCount();
 }
 
-std::string MerkleTree::getRootHash() const {
-    if (root == nullptr) {
-        return "";
-    }
-    return root->hash;
+size_t MerkleTree::getLevelCount() const {
+    return levels.getLevelCount();
 }
 
-void MerkleTree::printTree(MerkleNode* node, int depth) const {
-    if (node == nullptr) return;
+size_t MerkleTree::getLevelSize(size_t level) const {
+    return levels.getLevelSize(level);
+}
+
+const Hash256& MerkleTree::getNode(size_t level, size_t index) const {
+    return levels.getNode(level, index);
+}
+
+void MerkleTree::printTree(size_t level, size_t index, int depth) const {
     for (int i = 0; i < depth; i++) {
         std::cout << "  ";
     }
-    std::cout << "Hash: " << node->hash.substr(0, 16) << "..." << std::endl;
+    std::cout << "Hash: " << getNode(level, index).toHex().substr(0, 16) << "..." << std::endl;
 
-    if (node->left != nullptr || node->right != nullptr) {
-        printTree(node->left, depth + 1);
-        printTree(node->right, depth + 1);
+    if (level > 0) {
+        size_t left = 2 * index;
+        size_t right = left + 1 < getLevelSize(level - 1) ? left + 1 : left;
+        printTree(level - 1, left, depth + 1);
+        printTree(level - 1, right, depth + 1);
     }
 }
 
 void MerkleTree::printTree() const {
     std::cout << "\n=== Merkle Tree Structure" << std::endl;
-    printTree(root);
+    if (getLevelCount()) printTree(getLevelCount() - 1, 0, 0);
     std::cout << "========================\n" << std::endl;
 }
 
 bool MerkleTree::verifyTransaction(const std::string& transaction) const {
-    std::string txHash = sha256(transaction);
-    return searchHash(root, txHash);
+    size_t txIndex;
+    return findLeaf(sha256(transaction), txIndex);
+}
+
+void MerkleTree::buildLeafIndex() {
+    if (hasLeafIndex()) return;
+    leafIndex.reserve(getLeafCount());
+    // emplace keeps the first position of a duplicated transaction
+    for (size_t i = 0; i < getLeafCount(); i++) {
+        leafIndex.emplace(getNode(0, i), i);
+    }
+}
+
+bool MerkleTree::hasLeafIndex() const {
+    return !leafIndex.empty();
+}
+
+bool MerkleTree::findLeaf(const Hash256& leafHash, size_t& txIndex) const {
+    if (hasLeafIndex()) {
+        auto it = leafIndex.find(leafHash);
+        if (it == leafIndex.end()) return false;
+        txIndex = it->second;
+        return true;
+    }
+    for (size_t i = 0; i < getLeafCount(); i++) {
+        if (getNode(0, i) == leafHash) {
+            txIndex = i;
+            return true;
+        }
+    }
+    return false;
 }
 
-bool MerkleTree::searchHash(MerkleNode* node, const std::string& targetHash) const {
-    if (node == nullptr) return false;
+MerkleProof MerkleTree::getProof(size_t txIndex) const {
+    if (txIndex >= getLeafCount()) {
+        throw std::out_of_range("MerkleTree::getProof: no leaf " + std::to_string(txIndex));
+    }
+    MerkleProof proof;
+    proof.index = txIndex;
+    proof.siblings = levels.getPath(txIndex);
+    return proof;
+}
+
+bool MerkleTree::verifyProof(const Hash256& leafHash, const MerkleProof& proof, const Hash256& rootHash) {
+    return MerkleLevels::verifyPath(leafHash, proof.index, proof.siblings, 2, rootHash);
+}
 
-    if (node->hash == targetHash) return true;
-    return searchHash(node->left, targetHash) || searchHash(node->right, targetHash);
+bool MerkleTree::verifyProof(const std::string& transaction, const MerkleProof& proof, const Hash256& rootHash) {
+    return verifyProof(sha256(transaction), proof, rootHash);
 }
 
-MerkleTree::~MerkleTree() {
-    delete root;
+MerkleMultiProof MerkleTree::getMultiProof(const std::vector<size_t>& txIndices) const {
+    MerkleMultiProof proof;
+    proof.leafCount = getLeafCount();
+    proof.indices = txIndices;
+    std::sort(proof.indices.begin(), proof.indices.end());
+    proof.indices.erase(std::unique(proof.indices.begin(), proof.indices.end()), proof.indices.end());
+    if (!proof.indices.empty() && proof.indices.back() >= getLeafCount()) {
+        throw std::out_of_range("MerkleTree::getMultiProof: no leaf " + std::to_string(proof.indices.back()));
+    }
+
+    // Walk the levels with the sorted positions whose digests the verifier
+    // will know; a sibling is only emitted when it is not one of them.
+    std::vector<size_t> known = proof.indices;
+    for (size_t level = 0; level + 1 < getLevelCount(); level++) {
+        std::vector<size_t> parents;
+        for (size_t k = 0; k < known.size(); k++) {
+            size_t index = known[k];
+            size_t sibling = index ^ 1;
+            if (sibling < getLevelSize(level)) {
+                if (k + 1 < known.size() && known[k + 1] == sibling) {
+                    k++;
+                } else {
+                    proof.hashes.push_back(getNode(level, sibling));
+                }
+            }
+            parents.push_back(index / 2);
+        }
+        known.swap(parents);
+    }
+    return proof;
+}
+
+bool MerkleTree::verifyMultiProof(const std::vector<Hash256>& leafHashes, const MerkleMultiProof& proof, const Hash256& rootHash) {
+    if (proof.indices.empty() || leafHashes.size() != proof.indices.size()) return false;
+    for (size_t k = 0; k < proof.indices.size(); k++) {
+        if (proof.indices[k] >= proof.leafCount) return false;
+        if (k > 0 && proof.indices[k] <= proof.indices[k - 1]) return false;
+    }
+
+    std::vector<size_t> known = proof.indices;
+    std::vector<Hash256> digests = leafHashes;
+    size_t next = 0;
+    for (size_t width = proof.leafCount; width > 1; width = (width + 1) / 2) {
+        std::vector<size_t> parents;
+        std::vector<Hash256> parentDigests;
+        for (size_t k = 0; k < known.size(); k++) {
+            size_t index = known[k];
+            size_t sibling = index ^ 1;
+            const Hash256& digest = digests[k];
+            Hash256 siblingDigest;
+            if (sibling >= width) {
+                siblingDigest = digest;
+            } else if (k + 1 < known.size() && known[k + 1] == sibling) {
+                siblingDigest = digests[++k];
+            } else {
+                if (next == proof.hashes.size()) return false;
+                siblingDigest = proof.hashes[next++];
+            }
+            parents.push_back(index / 2);
+            parentDigests.push_back((index & 1) ? sha256(siblingDigest, digest) : sha256(digest, siblingDigest));
+        }
+        known.swap(parents);
+        digests.swap(parentDigests);
+    }
+    return next == proof.hashes.size() && digests[0] == rootHash;
 }
\ No newline at end of file
@@ -0,0 +1,74 @@
+#include "mining_job.h"
+#include <chrono>
+#include <stdexcept>
+
+MiningJob::MiningJob(const BlockHeader& hdr, const MiningOptions& opts)
+    : header(hdr), options(opts), cancelFlag(false) {
+    lastProgress.attempts = 0;
+    lastProgress.hashesPerSecond = 0.0;
+}
+
+// Nobody can collect the result any more, so stop mining instead of blocking
+// in the future's destructor until a nonce is found.
+MiningJob::~MiningJob() {
+    cancelFlag.store(true);
+}
+
+MiningHandle::MiningHandle() {}
+
+MiningHandle::MiningHandle(const std::shared_ptr<MiningJob>& j) : job(j) {}
+
+bool MiningHandle::valid() const {
+    return job != nullptr;
+}
+
+bool MiningHandle::ready() const {
+    return job && job->result.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+}
+
+void MiningHandle::cancel() {
+    if (job) job->cancelFlag.store(true);
+}
+
+bool MiningHandle::cancelled() const {
+    return job && job->cancelFlag.load();
+}
+
+MiningProgress MiningHandle::progress() const {
+    if (!job) return MiningProgress();
+    std::lock_guard<std::mutex> lock(job->progressMutex);
+    return job->lastProgress;
+}
+
+MiningResult MiningHandle::get() const {
+    if (!job || !job->result.valid()) throw std::logic_error("MiningHandle: no started mining job");
+    return job->result.get();
+}
+
+std::shared_ptr<MiningJob> MiningHandle::getJob() const {
+    return job;
+}
+
+MiningHandle startMiningJob(const std::shared_ptr<MiningJob>& job, const std::function<void(const MiningProgress&)>& onProgress) {
+    // The job owns the future that owns this task, so the task refers to the
+    // job by raw pointer; ~MiningJob joins the task before the job goes away.
+    MiningJob* j = job.get();
+    j->options.cancel = &j->cancelFlag;
+    std::function<void(const MiningProgress&)> userCallback = onProgress ? onProgress : j->options.onProgress;
+    j->options.onProgress = [j, userCallback](const MiningProgress& progress) {
+        {
+            std::lock_guard<std::mutex> lock(j->progressMutex);
+            j->lastProgress = progress;
+        }
+        if (userCallback) userCallback(progress);
+    };
+    j->result = std::async(std::launch::async, [j]() {
+        BlockHeader header = j->header;
+        MiningResult r;
+        r.hash = ProofOfWork::mineBlock(header, j->options);
+        r.nonce = header.nonce;
+        r.extraNonce = header.extraNonce;
+        return r;
+    }).share();
+    return MiningHandle(job);
+}
\ No newline at end of file
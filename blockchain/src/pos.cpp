@@ -1,31 +1,55 @@
 #include "pos.h"
 #include "utils.h"
-#include <random>
-#include <sstream>
-
-std::string ProofOfStake::validateBlock(const std::string& data, const std::string& previousHash, std::vector<Validator>& validators, std::string& selectedValidator) {
-    int totalStake = 0;
-    for (const auto& v : validators) totalStake += v.stake;
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_int_distribution<> dis(0, totalStake - 1);
-    int random = dis(gen);
-    int cumulative = 0;
-    for (const auto& v : validators) {
-        cumulative += v.stake;
-        if (random < cumulative) {
-            selectedValidator = v.id;
-            break;
-        }
+
+ProposerRng::ProposerRng(const Hash256& previousHash, uint64_t slot) : key(0), counter(0) {
+    Sha256Hasher hasher;
+    Hash256 seed = hasher.update(previousHash).updateUint64(slot).finalize();
+    for (int i = 7; i >= 0; i--) key = (key << 8) | seed.bytes[i];
+}
+
+uint64_t ProposerRng::operator()() {
+    uint64_t z = key + (++counter) * 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+uint64_t ProposerRng::nextBelow(uint64_t bound) {
+    // Rejects the lowest (2^64 mod bound) values so every residue is equally likely.
+    uint64_t threshold = (0 - bound) % bound;
+    for (;;) {
+        uint64_t r = (*this)();
+        if (r >= threshold) return r % bound;
     }
-    std::stringstream ss;
-    ss << data << previousHash << selectedValidator;
-    return sha256(ss.str());
 }
 
-bool ProofOfStake::verifyBlock(const std::string& data, const std::string& previousHash, const std::string& hash, const std::string& validator) {
-    std::stringstream ss;
-    ss << data << previousHash << validator;
-    std::string calculatedHash = sha256(ss.str());
+std::string ProofOfStake::selectProposer(const Hash256& previousHash, uint64_t slot, const StakeIndex& stakes) {
+    if (stakes.totalStake() == 0) return std::string();
+    ProposerRng rng(previousHash, slot);
+    return stakes.idAt(stakes.findByOffset(rng.nextBelow(stakes.totalStake())));
+}
+
+Hash256 ProofOfStake::sealHash(const BlockHeader& header, const std::string& validator) {
+    return header.hashWithProposer(validator);
+}
+
+Hash256 ProofOfStake::validateBlock(const BlockHeader& header, std::vector<Validator>& validators, std::string& selectedValidator) {
+    return validateBlock(header, StakeIndex(validators), selectedValidator);
+}
+
+Hash256 ProofOfStake::validateBlock(const BlockHeader& header, const StakeIndex& stakes,
+                                    std::string& selectedValidator) {
+    if (stakes.totalStake() > 0) selectedValidator = selectProposer(header.previousHash, header.height, stakes);
+    return sealHash(header, selectedValidator);
+}
+
+Hash256 ProofOfStake::validateBlock(const BlockHeader& header, const ProposerSchedule& schedule,
+                                    std::string& selectedValidator) {
+    if (schedule.covers(header.height)) selectedValidator = schedule.proposerAt(header.height);
+    return sealHash(header, selectedValidator);
+}
+
+bool ProofOfStake::verifyBlock(const BlockHeader& header, const Hash256& hash, const std::string& validator) {
+    Hash256 calculatedHash = sealHash(header, validator);
     return calculatedHash == hash;
 }
\ No newline at end of file
@@ -1,23 +1,215 @@
 #include "pow.h"
 #include "utils.h"
-#include <sstream>
+#include <atomic>
+#include <cstring>
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
+#include <thread>
+#include <vector>
 
-std::string ProofOfWork::mineBlock(const std::string& data, const std::string& previousHash, int difficulty, int& nonce) {
-    std::string target(difficulty, '0');
-    std::string blockData = data + previousHash + std::to_string(nonce);
-    std::string hash = sha256(blockData);
+static inline uint64_t loadBigEndian64(const unsigned char* p) {
+    uint64_t v = 0;
+    for (int i = 0; i < 8; i++) v = (v << 8) | p[i];
+    return v;
+}
+
+// Compares the digest and the target as four big-endian 64-bit words. Almost
+// every attempt is rejected by the first word.
+bool ProofOfWork::meetsTarget(const Hash256& hash, const Hash256& target) {
+    for (size_t i = 0; i < Hash256::SIZE; i += 8) {
+        uint64_t h = loadBigEndian64(hash.bytes + i);
+        uint64_t t = loadBigEndian64(target.bytes + i);
+        if (h != t) return h < t;
+    }
+    return true;
+}
+
+Hash256 ProofOfWork::targetFromZeroBits(int bits) {
+    if (bits < 0) bits = 0;
+    if (bits > 256) bits = 256;
+    Hash256 target;
+    std::memset(target.bytes, 0xff, Hash256::SIZE);
+    std::memset(target.bytes, 0, bits / 8);
+    if (bits < 256) target.bytes[bits / 8] = static_cast<unsigned char>(0xff >> (bits % 8));
+    return target;
+}
+
+int ProofOfWork::leadingZeroBits(const Hash256& hash) {
+    int bits = 0;
+    for (size_t i = 0; i < Hash256::SIZE; i++) {
+        unsigned char byte = hash.bytes[i];
+        if (byte == 0) {
+            bits += 8;
+            continue;
+        }
+        while (!(byte & 0x80)) {
+            bits++;
+            byte <<= 1;
+        }
+        break;
+    }
+    return bits;
+}
+
+uint32_t ProofOfWork::compactFromTarget(const Hash256& target) {
+    size_t first = 0;
+    while (first < Hash256::SIZE && target.bytes[first] == 0) first++;
+    if (first == Hash256::SIZE) return 0;
+    uint32_t size = static_cast<uint32_t>(Hash256::SIZE - first);
+    uint32_t mantissa = 0;
+    for (size_t i = first; i < first + 3; i++) {
+        mantissa = (mantissa << 8) | (i < Hash256::SIZE ? target.bytes[i] : 0);
+    }
+    // The top mantissa bit is a sign bit in this encoding.
+    if (mantissa & 0x00800000) {
+        mantissa >>= 8;
+        size++;
+    }
+    return (size << 24) | mantissa;
+}
+
+Hash256 ProofOfWork::targetFromCompact(uint32_t bits) {
+    int size = static_cast<int>(bits >> 24);
+    uint32_t mantissa = bits & 0x007fffff;
+    Hash256 target;
+    for (int k = 0; k < 3; k++) {
+        int pos = static_cast<int>(Hash256::SIZE) - size + k;
+        if (pos >= 0 && pos < static_cast<int>(Hash256::SIZE)) {
+            target.bytes[pos] = static_cast<unsigned char>(mantissa >> (16 - 8 * k));
+        }
+    }
+    return target;
+}
 
-    while (hash.substr(0, difficulty) != target) {
-        nonce++;
-        blockData = data + previousHash + std::to_string(nonce);
-        hash = sha256(blockData);
+// The search space is the 96-bit counter extraNonce:nonce. Attempt i of a
+// search that starts at (extraNonce, nonce) is nonce + i, carrying into the
+// extra-nonce when the 64-bit nonce wraps, so no pair is ever tried twice.
+static void attemptAt(uint64_t startNonce, uint32_t startExtra, uint64_t i, uint64_t& nonce, uint32_t& extraNonce) {
+    nonce = startNonce + i;
+    extraNonce = startExtra + (nonce < startNonce ? 1 : 0);
+}
+
+Hash256 ProofOfWork::mineBlock(BlockHeader& header) {
+    return mineBlock(header, MiningOptions());
+}
+
+// State shared by the workers of one mineBlock call.
+struct NonceSearch {
+    // SHA-256 state after the first MIDSTATE_SIZE header bytes, which never
+    // change while mining, and the remaining bytes that hold the nonces.
+    Sha256Hasher midstate;
+    unsigned char tail[BlockHeader::SIZE - BlockHeader::MIDSTATE_SIZE];
+    Hash256 target;
+    uint64_t startNonce;
+    uint32_t startExtra;
+    uint64_t stride;
+    const MiningOptions* options;
+    std::chrono::steady_clock::time_point started;
+    std::atomic<bool> stop;
+    std::atomic<bool> found;
+    std::atomic<uint64_t> best;
+    std::atomic<uint64_t> attempts;
+};
+
+static const uint64_t CHECK_INTERVAL = 4096;
+
+static void putNonces(unsigned char* tail, uint64_t nonce, uint32_t extraNonce) {
+    unsigned char* extra = tail + (BlockHeader::EXTRA_NONCE_OFFSET - BlockHeader::MIDSTATE_SIZE);
+    unsigned char* n = tail + (BlockHeader::NONCE_OFFSET - BlockHeader::MIDSTATE_SIZE);
+    for (int i = 0; i < 4; i++) extra[i] = static_cast<unsigned char>(extraNonce >> (8 * i));
+    for (int i = 0; i < 8; i++) n[i] = static_cast<unsigned char>(nonce >> (8 * i));
+}
+
+// Worker `offset` tries attempts offset, offset + stride, ... Each worker
+// visits its attempts in increasing order, so in deterministic mode it can
+// stop as soon as it passes the lowest solution found so far; otherwise every
+// worker stops at the first solution anyone finds. Cancellation and progress
+// are handled once per CHECK_INTERVAL attempts; worker 0 reports progress.
+static void searchNonces(NonceSearch& search, uint64_t offset) {
+    const MiningOptions& options = *search.options;
+    std::chrono::steady_clock::time_point lastReport = search.started;
+    unsigned char tail[sizeof(search.tail)];
+    std::memcpy(tail, search.tail, sizeof(tail));
+    uint64_t sinceCheck = 0;
+    for (uint64_t i = offset; i >= offset; i += search.stride) {
+        if (options.deterministic ? i > search.best.load(std::memory_order_relaxed)
+                                  : search.found.load(std::memory_order_relaxed)) break;
+        if (++sinceCheck == CHECK_INTERVAL) {
+            search.attempts.fetch_add(sinceCheck, std::memory_order_relaxed);
+            sinceCheck = 0;
+            if (search.stop.load(std::memory_order_relaxed)) break;
+            if (options.cancel && options.cancel->load(std::memory_order_relaxed)) {
+                search.stop.store(true);
+                break;
+            }
+            if (offset == 0 && options.onProgress) {
+                std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+                if (now - lastReport >= options.progressInterval) {
+                    lastReport = now;
+                    MiningProgress progress;
+                    progress.attempts = search.attempts.load(std::memory_order_relaxed);
+                    double seconds = std::chrono::duration<double>(now - search.started).count();
+                    progress.hashesPerSecond = seconds > 0 ? progress.attempts / seconds : 0.0;
+                    options.onProgress(progress);
+                }
+            }
+        }
+
+        uint64_t nonce;
+        uint32_t extraNonce;
+        attemptAt(search.startNonce, search.startExtra, i, nonce, extraNonce);
+        putNonces(tail, nonce, extraNonce);
+        Sha256Hasher hasher = search.midstate;
+        Hash256 hash = hasher.update(tail, sizeof(tail)).finalize();
+        if (!ProofOfWork::meetsTarget(hash, search.target)) continue;
+
+        uint64_t current = search.best.load();
+        while (i < current && !search.best.compare_exchange_weak(current, i)) {}
+        search.found.store(true);
+        break;
+    }
+    search.attempts.fetch_add(sinceCheck, std::memory_order_relaxed);
+}
+
+Hash256 ProofOfWork::mineBlock(BlockHeader& header, const MiningOptions& options) {
+    unsigned threads = options.threads ? options.threads : std::thread::hardware_concurrency();
+    if (threads == 0) threads = 1;
+
+    NonceSearch search;
+    unsigned char bytes[BlockHeader::SIZE];
+    header.serialize(bytes);
+    search.midstate.update(bytes, BlockHeader::MIDSTATE_SIZE);
+    std::memcpy(search.tail, bytes + BlockHeader::MIDSTATE_SIZE, sizeof(search.tail));
+    search.target = targetFromCompact(header.bits);
+    search.startNonce = header.nonce;
+    search.startExtra = header.extraNonce;
+    search.stride = threads;
+    search.options = &options;
+    search.started = std::chrono::steady_clock::now();
+    search.stop.store(false);
+    search.found.store(false);
+    search.best.store(UINT64_MAX);
+    search.attempts.store(0);
+
+    if (threads == 1) {
+        searchNonces(search, 0);
+    } else {
+        std::vector<std::thread> workers;
+        for (unsigned t = 0; t < threads; t++) {
+            workers.push_back(std::thread(searchNonces, std::ref(search), static_cast<uint64_t>(t)));
+        }
+        for (auto& worker : workers) worker.join();
     }
-    return hash;
+
+    if (search.stop.load()) throw MiningCancelled();
+    // Only reachable after 2^64 attempts in one call.
+    if (!search.found.load()) throw std::runtime_error("ProofOfWork::mineBlock: nonce space exhausted");
+    attemptAt(search.startNonce, search.startExtra, search.best.load(), header.nonce, header.extraNonce);
+    return header.hash();
 }
 
-bool ProofOfWork::verifyBlock(const std::string& data, const std::string& previousHash, const std::string& hash, int difficulty, int nonce) {
-    std::string target(difficulty, '0');
-    std::string blockData = data + previousHash + std::to_string(nonce);
-    std::string calculatedHash = sha256(blockData);
-    return calculatedHash == hash && calculatedHash.substr(0, difficulty) == target;
+bool ProofOfWork::verifyBlock(const BlockHeader& header, const Hash256& hash) {
+    Hash256 calculatedHash = header.hash();
+    return calculatedHash == hash && meetsTarget(calculatedHash, targetFromCompact(header.bits));
 }
\ No newline at end of file
@@ -0,0 +1,65 @@
+#include "proposer_schedule.h"
+#include "pos.h"
+#include "sparse_merkle_tree.h"
+#include <algorithm>
+#include <unordered_map>
+#include <utility>
+
+const size_t ProposerSchedule::DEFAULT_EPOCH_LENGTH;
+
+StakeSnapshot StakeSnapshot::of(const StakeIndex& index) {
+    std::vector<std::pair<Hash256, size_t>> order;
+    order.reserve(index.size());
+    for (size_t i = 0; i < index.size(); i++) order.push_back(std::make_pair(SparseMerkleTree::keyFor(index.idAt(i)), i));
+    std::sort(order.begin(), order.end());
+    StakeSnapshot snapshot;
+    snapshot.ids.reserve(order.size());
+    snapshot.stakes.reserve(order.size());
+    for (const auto& entry : order) {
+        const std::string& id = index.idAt(entry.second);
+        snapshot.ids.push_back(id);
+        snapshot.stakes.push_back(index.stakeOf(id));
+    }
+    return snapshot;
+}
+
+StakeIndex StakeSnapshot::toIndex() const {
+    StakeIndex index;
+    for (size_t i = 0; i < ids.size(); i++) index.deposit(ids[i], stakes[i]);
+    return index;
+}
+
+ProposerSchedule::ProposerSchedule() : firstSlot(0) {}
+
+ProposerSchedule ProposerSchedule::build(const Hash256& seed, uint64_t firstSlot, size_t length, const StakeIndex& stakes) {
+    ProposerSchedule schedule;
+    schedule.firstSlot = firstSlot;
+    schedule.seed = seed;
+    if (stakes.totalStake() == 0) return schedule;
+
+    ProposerRng rng(seed, firstSlot);
+    std::unordered_map<size_t, uint32_t> seen;
+    schedule.proposers.reserve(length);
+    for (size_t i = 0; i < length; i++) {
+        size_t slot = stakes.findByOffset(rng.nextBelow(stakes.totalStake()));
+        auto found = seen.find(slot);
+        if (found == seen.end()) {
+            found = seen.insert(std::make_pair(slot, static_cast<uint32_t>(schedule.ids.size()))).first;
+            schedule.ids.push_back(stakes.idAt(slot));
+        }
+        schedule.proposers.push_back(found->second);
+    }
+    return schedule;
+}
+
+bool ProposerSchedule::empty() const {
+    return proposers.empty();
+}
+
+bool ProposerSchedule::covers(uint64_t slot) const {
+    return slot >= firstSlot && slot - firstSlot < proposers.size();
+}
+
+const std::string& ProposerSchedule::proposerAt(uint64_t slot) const {
+    return ids[proposers[slot - firstSlot]];
+}
\ No newline at end of file
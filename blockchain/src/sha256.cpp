@@ -0,0 +1,410 @@
+#include "sha256.h"
+#include <openssl/sha.h>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SHA256_X86_KERNELS 1
+#include <cpuid.h>
+#include <immintrin.h>
+#endif
+
+static const uint32_t K[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+const uint32_t SHA256_INITIAL_STATE[8] = {
+    0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+};
+
+static void storeDigest(const uint32_t state[8], Hash256& digest) {
+    for (int i = 0; i < 8; i++) {
+        digest.bytes[4 * i] = static_cast<unsigned char>(state[i] >> 24);
+        digest.bytes[4 * i + 1] = static_cast<unsigned char>(state[i] >> 16);
+        digest.bytes[4 * i + 2] = static_cast<unsigned char>(state[i] >> 8);
+        digest.bytes[4 * i + 3] = static_cast<unsigned char>(state[i]);
+    }
+}
+
+// Builds the padded final block(s) of a message: the bytes past the last full
+// 64-byte block, 0x80, zero fill and the big-endian bit length. Returns how
+// many blocks (1 or 2) were written to `tail`.
+static size_t padTail(const unsigned char* message, size_t length, unsigned char tail[128]) {
+    size_t full = length & ~static_cast<size_t>(63);
+    size_t rem = length - full;
+    size_t tailBlocks = (rem + 9 <= 64) ? 1 : 2;
+    std::memset(tail, 0, 128);
+    if (rem) std::memcpy(tail, message + full, rem);
+    tail[rem] = 0x80;
+    uint64_t bits = static_cast<uint64_t>(length) * 8;
+    unsigned char* end = tail + tailBlocks * 64;
+    for (int i = 1; i <= 8; i++) {
+        end[-i] = static_cast<unsigned char>(bits);
+        bits >>= 8;
+    }
+    return tailBlocks;
+}
+
+static inline uint32_t rotr(uint32_t x, int n) {
+    return (x >> n) | (x << (32 - n));
+}
+
+static void compressScalar(uint32_t state[8], const unsigned char* data, size_t blocks) {
+    while (blocks--) {
+        uint32_t w[64];
+        for (int t = 0; t < 16; t++) {
+            w[t] = (static_cast<uint32_t>(data[4 * t]) << 24) | (static_cast<uint32_t>(data[4 * t + 1]) << 16) |
+                   (static_cast<uint32_t>(data[4 * t + 2]) << 8) | static_cast<uint32_t>(data[4 * t + 3]);
+        }
+        for (int t = 16; t < 64; t++) {
+            uint32_t s0 = rotr(w[t - 15], 7) ^ rotr(w[t - 15], 18) ^ (w[t - 15] >> 3);
+            uint32_t s1 = rotr(w[t - 2], 17) ^ rotr(w[t - 2], 19) ^ (w[t - 2] >> 10);
+            w[t] = w[t - 16] + s0 + w[t - 7] + s1;
+        }
+        uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+        uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+        for (int t = 0; t < 64; t++) {
+            uint32_t s1 = rotr(e, 6) ^ rotr(e, 11) ^ rotr(e, 25);
+            uint32_t ch = (e & f) ^ (~e & g);
+            uint32_t t1 = h + s1 + ch + K[t] + w[t];
+            uint32_t s0 = rotr(a, 2) ^ rotr(a, 13) ^ rotr(a, 22);
+            uint32_t maj = (a & b) ^ (a & c) ^ (b & c);
+            uint32_t t2 = s0 + maj;
+            h = g; g = f; f = e; e = d + t1;
+            d = c; c = b; b = a; a = t1 + t2;
+        }
+        state[0] += a; state[1] += b; state[2] += c; state[3] += d;
+        state[4] += e; state[5] += f; state[6] += g; state[7] += h;
+        data += 64;
+    }
+}
+
+#ifdef SHA256_X86_KERNELS
+
+static uint64_t readXcr0() {
+    uint32_t eax, edx;
+    __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return (static_cast<uint64_t>(edx) << 32) | eax;
+}
+
+static bool cpuHasAvx2() {
+    unsigned int a, b, c, d;
+    if (!__get_cpuid(1, &a, &b, &c, &d)) return false;
+    if (!(c & bit_OSXSAVE) || !(c & bit_AVX)) return false;
+    // The OS must save the YMM registers on context switch.
+    if ((readXcr0() & 0x6) != 0x6) return false;
+    if (!__get_cpuid_count(7, 0, &a, &b, &c, &d)) return false;
+    return (b & bit_AVX2) != 0;
+}
+
+static bool cpuHasShaNi() {
+    unsigned int a, b, c, d;
+    if (!__get_cpuid(1, &a, &b, &c, &d)) return false;
+    if (!(c & bit_SSSE3) || !(c & bit_SSE4_1)) return false;
+    if (!__get_cpuid_count(7, 0, &a, &b, &c, &d)) return false;
+    return (b & bit_SHA) != 0;
+}
+
+// Single-message compression with the SHA extensions (two rounds per
+// sha256rnds2, message schedule via sha256msg1/msg2).
+__attribute__((target("sha,sse4.1")))
+static void compressShaNi(uint32_t state[8], const unsigned char* data, size_t blocks) {
+    const __m128i byteSwap = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+
+    __m128i tmp = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&state[0]));
+    __m128i state1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&state[4]));
+    tmp = _mm_shuffle_epi32(tmp, 0xB1);            // CDAB
+    state1 = _mm_shuffle_epi32(state1, 0x1B);      // EFGH
+    __m128i state0 = _mm_alignr_epi8(tmp, state1, 8);  // ABEF
+    state1 = _mm_blend_epi16(state1, tmp, 0xF0);   // CDGH
+
+    while (blocks--) {
+        __m128i abefSave = state0;
+        __m128i cdghSave = state1;
+        __m128i w[4];
+        for (int i = 0; i < 4; i++) {
+            w[i] = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 16 * i)), byteSwap);
+        }
+#pragma GCC unroll 16
+        for (int r = 0; r < 16; r++) {
+            if (r >= 4) {
+                __m128i w1 = w[(r + 3) & 3];  // W[t-4..t-1]
+                __m128i w2 = w[(r + 2) & 3];  // W[t-8..t-5]
+                __m128i next = _mm_sha256msg1_epu32(w[r & 3], w[(r + 1) & 3]);
+                next = _mm_add_epi32(next, _mm_alignr_epi8(w1, w2, 4));
+                w[r & 3] = _mm_sha256msg2_epu32(next, w1);
+            }
+            __m128i msg = _mm_add_epi32(w[r & 3], _mm_loadu_si128(reinterpret_cast<const __m128i*>(&K[4 * r])));
+            state1 = _mm_sha256rnds2_epu32(state1, state0, msg);
+            msg = _mm_shuffle_epi32(msg, 0x0E);
+            state0 = _mm_sha256rnds2_epu32(state0, state1, msg);
+        }
+        state0 = _mm_add_epi32(state0, abefSave);
+        state1 = _mm_add_epi32(state1, cdghSave);
+        data += 64;
+    }
+
+    tmp = _mm_shuffle_epi32(state0, 0x1B);         // FEBA
+    state1 = _mm_shuffle_epi32(state1, 0xB1);      // DCHG
+    state0 = _mm_blend_epi16(tmp, state1, 0xF0);   // DCBA
+    state1 = _mm_alignr_epi8(state1, tmp, 8);      // HGFE
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(&state[0]), state0);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(&state[4]), state1);
+}
+
+__attribute__((target("sha,sse4.1")))
+static void hashShaNi(const unsigned char* message, size_t length, Hash256& digest) {
+    uint32_t state[8];
+    std::memcpy(state, SHA256_INITIAL_STATE, sizeof(state));
+    size_t fullBlocks = length / 64;
+    if (fullBlocks) compressShaNi(state, message, fullBlocks);
+    unsigned char tail[128];
+    size_t tailBlocks = padTail(message, length, tail);
+    compressShaNi(state, tail, tailBlocks);
+    storeDigest(state, digest);
+}
+
+#define ROTR8(x, n) _mm256_or_si256(_mm256_srli_epi32((x), (n)), _mm256_slli_epi32((x), 32 - (n)))
+
+// Transposes an 8x8 matrix of 32-bit words held in eight YMM registers.
+__attribute__((target("avx2")))
+static inline void transpose8x8(__m256i r[8]) {
+    __m256i t0 = _mm256_unpacklo_epi32(r[0], r[1]);
+    __m256i t1 = _mm256_unpackhi_epi32(r[0], r[1]);
+    __m256i t2 = _mm256_unpacklo_epi32(r[2], r[3]);
+    __m256i t3 = _mm256_unpackhi_epi32(r[2], r[3]);
+    __m256i t4 = _mm256_unpacklo_epi32(r[4], r[5]);
+    __m256i t5 = _mm256_unpackhi_epi32(r[4], r[5]);
+    __m256i t6 = _mm256_unpacklo_epi32(r[6], r[7]);
+    __m256i t7 = _mm256_unpackhi_epi32(r[6], r[7]);
+    __m256i u0 = _mm256_unpacklo_epi64(t0, t2);
+    __m256i u1 = _mm256_unpackhi_epi64(t0, t2);
+    __m256i u2 = _mm256_unpacklo_epi64(t1, t3);
+    __m256i u3 = _mm256_unpackhi_epi64(t1, t3);
+    __m256i u4 = _mm256_unpacklo_epi64(t4, t6);
+    __m256i u5 = _mm256_unpackhi_epi64(t4, t6);
+    __m256i u6 = _mm256_unpacklo_epi64(t5, t7);
+    __m256i u7 = _mm256_unpackhi_epi64(t5, t7);
+    r[0] = _mm256_permute2x128_si256(u0, u4, 0x20);
+    r[1] = _mm256_permute2x128_si256(u1, u5, 0x20);
+    r[2] = _mm256_permute2x128_si256(u2, u6, 0x20);
+    r[3] = _mm256_permute2x128_si256(u3, u7, 0x20);
+    r[4] = _mm256_permute2x128_si256(u0, u4, 0x31);
+    r[5] = _mm256_permute2x128_si256(u1, u5, 0x31);
+    r[6] = _mm256_permute2x128_si256(u2, u6, 0x31);
+    r[7] = _mm256_permute2x128_si256(u3, u7, 0x31);
+}
+
+// One compression of eight independent blocks; lane i of every register
+// belongs to message i. `state` holds word j of all eight lanes in state[j].
+__attribute__((target("avx2")))
+static void compressAvx2x8(__m256i state[8], const unsigned char* const blocks[8]) {
+    const __m256i byteSwap = _mm256_setr_epi8(
+        3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12,
+        3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+
+    __m256i w[64];
+    for (int half = 0; half < 2; half++) {
+        __m256i rows[8];
+        for (int lane = 0; lane < 8; lane++) {
+            rows[lane] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(blocks[lane] + 32 * half));
+        }
+        transpose8x8(rows);
+        for (int i = 0; i < 8; i++) {
+            w[8 * half + i] = _mm256_shuffle_epi8(rows[i], byteSwap);
+        }
+    }
+    for (int t = 16; t < 64; t++) {
+        __m256i w15 = w[t - 15];
+        __m256i w2 = w[t - 2];
+        __m256i s0 = _mm256_xor_si256(_mm256_xor_si256(ROTR8(w15, 7), ROTR8(w15, 18)), _mm256_srli_epi32(w15, 3));
+        __m256i s1 = _mm256_xor_si256(_mm256_xor_si256(ROTR8(w2, 17), ROTR8(w2, 19)), _mm256_srli_epi32(w2, 10));
+        w[t] = _mm256_add_epi32(_mm256_add_epi32(w[t - 16], s0), _mm256_add_epi32(w[t - 7], s1));
+    }
+
+    __m256i a = state[0], b = state[1], c = state[2], d = state[3];
+    __m256i e = state[4], f = state[5], g = state[6], h = state[7];
+    for (int t = 0; t < 64; t++) {
+        __m256i s1 = _mm256_xor_si256(_mm256_xor_si256(ROTR8(e, 6), ROTR8(e, 11)), ROTR8(e, 25));
+        __m256i ch = _mm256_xor_si256(_mm256_and_si256(e, f), _mm256_andnot_si256(e, g));
+        __m256i t1 = _mm256_add_epi32(_mm256_add_epi32(h, s1), _mm256_add_epi32(ch, w[t]));
+        t1 = _mm256_add_epi32(t1, _mm256_set1_epi32(static_cast<int>(K[t])));
+        __m256i s0 = _mm256_xor_si256(_mm256_xor_si256(ROTR8(a, 2), ROTR8(a, 13)), ROTR8(a, 22));
+        __m256i maj = _mm256_xor_si256(_mm256_and_si256(a, b), _mm256_and_si256(c, _mm256_xor_si256(a, b)));
+        __m256i t2 = _mm256_add_epi32(s0, maj);
+        h = g; g = f; f = e;
+        e = _mm256_add_epi32(d, t1);
+        d = c; c = b; b = a;
+        a = _mm256_add_epi32(t1, t2);
+    }
+    state[0] = _mm256_add_epi32(state[0], a);
+    state[1] = _mm256_add_epi32(state[1], b);
+    state[2] = _mm256_add_epi32(state[2], c);
+    state[3] = _mm256_add_epi32(state[3], d);
+    state[4] = _mm256_add_epi32(state[4], e);
+    state[5] = _mm256_add_epi32(state[5], f);
+    state[6] = _mm256_add_epi32(state[6], g);
+    state[7] = _mm256_add_epi32(state[7], h);
+}
+
+#undef ROTR8
+
+// Hashes up to eight messages, one per lane. Lanes that run out of blocks
+// keep compressing a dummy block; their digest was captured when they ended.
+__attribute__((target("avx2")))
+static void hashAvx2x8(const unsigned char* const* messages, const size_t* lengths, size_t count, Hash256* digests) {
+    static const unsigned char dummy[64] = {0};
+    unsigned char tails[8][128];
+    size_t fullBlocks[8];
+    size_t totalBlocks[8];
+    size_t maxBlocks = 0;
+    for (size_t lane = 0; lane < 8; lane++) {
+        if (lane < count) {
+            fullBlocks[lane] = lengths[lane] / 64;
+            totalBlocks[lane] = fullBlocks[lane] + padTail(messages[lane], lengths[lane], tails[lane]);
+        } else {
+            fullBlocks[lane] = 0;
+            totalBlocks[lane] = 0;
+        }
+        if (totalBlocks[lane] > maxBlocks) maxBlocks = totalBlocks[lane];
+    }
+
+    __m256i state[8];
+    for (int i = 0; i < 8; i++) state[i] = _mm256_set1_epi32(static_cast<int>(SHA256_INITIAL_STATE[i]));
+
+    for (size_t block = 0; block < maxBlocks; block++) {
+        const unsigned char* ptrs[8];
+        for (size_t lane = 0; lane < 8; lane++) {
+            if (block < fullBlocks[lane]) {
+                ptrs[lane] = messages[lane] + 64 * block;
+            } else if (block < totalBlocks[lane]) {
+                ptrs[lane] = tails[lane] + 64 * (block - fullBlocks[lane]);
+            } else {
+                ptrs[lane] = dummy;
+            }
+        }
+        compressAvx2x8(state, ptrs);
+
+        bool anyDone = false;
+        for (size_t lane = 0; lane < count && lane < 8; lane++) {
+            if (totalBlocks[lane] == block + 1) anyDone = true;
+        }
+        if (!anyDone) continue;
+        alignas(32) uint32_t words[8][8];
+        for (int i = 0; i < 8; i++) _mm256_store_si256(reinterpret_cast<__m256i*>(words[i]), state[i]);
+        for (size_t lane = 0; lane < count && lane < 8; lane++) {
+            if (totalBlocks[lane] != block + 1) continue;
+            uint32_t laneState[8];
+            for (int i = 0; i < 8; i++) laneState[i] = words[i][lane];
+            storeDigest(laneState, digests[lane]);
+        }
+    }
+}
+
+#endif // SHA256_X86_KERNELS
+
+bool sha256BackendSupported(Sha256Backend backend) {
+    switch (backend) {
+    case SHA256_BACKEND_SCALAR:
+        return true;
+#ifdef SHA256_X86_KERNELS
+    case SHA256_BACKEND_AVX2: {
+        static const bool supported = cpuHasAvx2();
+        return supported;
+    }
+    case SHA256_BACKEND_SHANI: {
+        static const bool supported = cpuHasShaNi();
+        return supported;
+    }
+#endif
+    default:
+        return false;
+    }
+}
+
+static Sha256Backend detectBackend() {
+    if (sha256BackendSupported(SHA256_BACKEND_SHANI)) return SHA256_BACKEND_SHANI;
+    if (sha256BackendSupported(SHA256_BACKEND_AVX2)) return SHA256_BACKEND_AVX2;
+    return SHA256_BACKEND_SCALAR;
+}
+
+static std::atomic<int>& activeBackend() {
+    static std::atomic<int> backend(detectBackend());
+    return backend;
+}
+
+Sha256Backend sha256Backend() {
+    return static_cast<Sha256Backend>(activeBackend().load(std::memory_order_relaxed));
+}
+
+const char* sha256BackendName(Sha256Backend backend) {
+    switch (backend) {
+    case SHA256_BACKEND_AVX2: return "avx2";
+    case SHA256_BACKEND_SHANI: return "sha-ni";
+    default: return "scalar";
+    }
+}
+
+bool setSha256Backend(Sha256Backend backend) {
+    if (!sha256BackendSupported(backend)) return false;
+    activeBackend().store(backend, std::memory_order_relaxed);
+    return true;
+}
+
+void sha256Compress(uint32_t state[8], const unsigned char* blocks, size_t blockCount) {
+#ifdef SHA256_X86_KERNELS
+    if (sha256Backend() == SHA256_BACKEND_SHANI) {
+        compressShaNi(state, blocks, blockCount);
+        return;
+    }
+#endif
+    compressScalar(state, blocks, blockCount);
+}
+
+void sha256_batch(const unsigned char* const* messages, const size_t* lengths, size_t count, Hash256* digests) {
+    switch (sha256Backend()) {
+#ifdef SHA256_X86_KERNELS
+    case SHA256_BACKEND_SHANI:
+        for (size_t i = 0; i < count; i++) hashShaNi(messages[i], lengths[i], digests[i]);
+        return;
+    case SHA256_BACKEND_AVX2:
+        for (size_t i = 0; i < count; i += 8) {
+            hashAvx2x8(messages + i, lengths + i, count - i, digests + i);
+        }
+        return;
+#endif
+    default:
+        for (size_t i = 0; i < count; i++) SHA256(messages[i], lengths[i], digests[i].data());
+        return;
+    }
+}
+
+void sha256_batch(const unsigned char* const* messages, size_t length, size_t count, Hash256* digests) {
+    const size_t chunk = 64;
+    size_t lengths[chunk];
+    for (size_t i = 0; i < chunk; i++) lengths[i] = length;
+    for (size_t i = 0; i < count; i += chunk) {
+        size_t n = (count - i < chunk) ? count - i : chunk;
+        sha256_batch(messages + i, lengths, n, digests + i);
+    }
+}
+
+std::vector<Hash256> sha256_batch(const std::vector<std::string>& messages) {
+    std::vector<const unsigned char*> ptrs(messages.size());
+    std::vector<size_t> lengths(messages.size());
+    for (size_t i = 0; i < messages.size(); i++) {
+        ptrs[i] = reinterpret_cast<const unsigned char*>(messages[i].data());
+        lengths[i] = messages[i].size();
+    }
+    std::vector<Hash256> digests(messages.size());
+    if (!messages.empty()) sha256_batch(ptrs.data(), lengths.data(), messages.size(), digests.data());
+    return digests;
+}
@@ -0,0 +1,191 @@
+#include "sparse_merkle_tree.h"
+#include "utils.h"
+#include <algorithm>
+#include <iterator>
+
+const size_t SparseMerkleTree::DEPTH;
+
+// Bit `position` of a key, counting from the most significant bit.
+static bool bitAt(const Hash256& key, size_t position) {
+    return (key.bytes[position / 8] >> (7 - position % 8)) & 1;
+}
+
+// The first `bits` bits of key, zero after that.
+static Hash256 prefixOf(const Hash256& key, size_t bits) {
+    Hash256 prefix;
+    size_t whole = bits / 8;
+    for (size_t i = 0; i < whole; i++) prefix.bytes[i] = key.bytes[i];
+    if (bits % 8) prefix.bytes[whole] = key.bytes[whole] & static_cast<unsigned char>(0xff << (8 - bits % 8));
+    return prefix;
+}
+
+static Hash256 withBit(const Hash256& prefix, size_t position) {
+    Hash256 result = prefix;
+    result.bytes[position / 8] |= static_cast<unsigned char>(0x80 >> (position % 8));
+    return result;
+}
+
+SparseMerkleTree::SparseMerkleTree() : cache(DEPTH + 1), root(defaultHash(DEPTH)) {}
+
+Hash256 SparseMerkleTree::keyFor(const std::string& accountId) {
+    return sha256(accountId);
+}
+
+static std::vector<Hash256> buildDefaults() {
+    std::vector<Hash256> defaults(SparseMerkleTree::DEPTH + 1);
+    for (size_t h = 1; h <= SparseMerkleTree::DEPTH; h++) defaults[h] = sha256(defaults[h - 1], defaults[h - 1]);
+    return defaults;
+}
+
+const Hash256& SparseMerkleTree::defaultHash(size_t height) {
+    static const std::vector<Hash256> defaults = buildDefaults();
+    return defaults[height];
+}
+
+// The leading 0x00 makes leaf inputs 65 bytes, so they can never collide
+// with 64-byte interior nodes.
+Hash256 SparseMerkleTree::leafHash(const Hash256& key, const Hash256& value) {
+    const unsigned char tag = 0;
+    Sha256Hasher hasher;
+    hasher.update(&tag, 1).update(key).update(value);
+    return hasher.finalize();
+}
+
+void SparseMerkleTree::update(const Hash256& key, const Hash256& value) {
+    if (value.empty()) leaves.erase(key);
+    else leaves[key] = value;
+    dirty.push_back(key);
+}
+
+void SparseMerkleTree::update(const std::vector<std::pair<Hash256, Hash256>>& updates) {
+    for (const auto& u : updates) update(u.first, u.second);
+}
+
+Hash256 SparseMerkleTree::get(const Hash256& key) const {
+    auto it = leaves.find(key);
+    return it == leaves.end() ? Hash256() : it->second;
+}
+
+size_t SparseMerkleTree::size() const {
+    return leaves.size();
+}
+
+size_t SparseMerkleTree::getCacheSize() const {
+    refresh();
+    size_t nodes = 0;
+    for (const auto& level : cache) nodes += level.size();
+    return nodes;
+}
+
+// Number of leading bits two keys share.
+static size_t commonPrefixBits(const Hash256& a, const Hash256& b) {
+    size_t i = 0;
+    while (i < Hash256::SIZE && a.bytes[i] == b.bytes[i]) i++;
+    if (i == Hash256::SIZE) return SparseMerkleTree::DEPTH;
+    size_t bits = i * 8;
+    for (unsigned char diff = a.bytes[i] ^ b.bytes[i]; !(diff & 0x80); diff <<= 1) bits++;
+    return bits;
+}
+
+// Drops every cached node below `height` that held two or more of `keys`
+// (sorted): those are exactly the nodes on the shared path of two adjacent
+// keys, so nodes that held a single key are never probed.
+void SparseMerkleTree::purge(size_t height, const std::vector<Hash256>& keys) const {
+    for (size_t i = 1; i < keys.size(); i++) {
+        size_t shared = commonPrefixBits(keys[i - 1], keys[i]);
+        for (size_t h = height; h >= 1 && DEPTH - h <= shared; h--) cache[h].erase(prefixOf(keys[i], DEPTH - h));
+    }
+}
+
+// Hash of the height-`height` subtree whose keys start with `prefix`; its
+// leaves are [first, last) and its pending changes [dirtyFirst, dirtyLast).
+// Subtrees without pending changes come straight from the cache.
+Hash256 SparseMerkleTree::nodeHash(size_t height, const Hash256& prefix, LeafIt first, LeafIt last,
+                                   DirtyIt dirtyFirst, DirtyIt dirtyLast) const {
+    bool clean = dirtyFirst == dirtyLast;
+    if (first == last || std::next(first) == last) {
+        // Collapsed to at most one leaf. Any cached node inside held two or
+        // more leaves before this batch, all of them now either pending or
+        // the remaining leaf.
+        if (!clean) {
+            std::vector<Hash256> keys(dirtyFirst, dirtyLast);
+            if (first != last) {
+                auto at = std::lower_bound(keys.begin(), keys.end(), first->first);
+                if (at == keys.end() || *at != first->first) keys.insert(at, first->first);
+            }
+            purge(height, keys);
+        }
+        return first == last ? defaultHash(height) : leafHash(first->first, first->second);
+    }
+    if (clean) return cache[height].find(prefix)->second;
+
+    size_t position = DEPTH - height;
+    Hash256 rightPrefix = withBit(prefix, position);
+    LeafIt middle = leaves.lower_bound(rightPrefix);
+    DirtyIt dirtyMiddle = std::lower_bound(dirtyFirst, dirtyLast, rightPrefix);
+    Hash256 left = nodeHash(height - 1, prefix, first, middle, dirtyFirst, dirtyMiddle);
+    Hash256 right = nodeHash(height - 1, rightPrefix, middle, last, dirtyMiddle, dirtyLast);
+    Hash256 hash = sha256(left, right);
+    cache[height][prefix] = hash;
+    return hash;
+}
+
+void SparseMerkleTree::refresh() const {
+    if (dirty.empty()) return;
+    std::sort(dirty.begin(), dirty.end());
+    dirty.erase(std::unique(dirty.begin(), dirty.end()), dirty.end());
+    root = nodeHash(DEPTH, Hash256(), leaves.begin(), leaves.end(), dirty.begin(), dirty.end());
+    dirty.clear();
+}
+
+Hash256 SparseMerkleTree::getRootHash() const {
+    refresh();
+    return root;
+}
+
+SparseMerkleProof SparseMerkleTree::getProof(const Hash256& key) const {
+    refresh();
+    SparseMerkleProof proof;
+    DirtyIt none = dirty.end();
+    Hash256 prefix;
+    LeafIt first = leaves.begin();
+    LeafIt last = leaves.end();
+    for (size_t height = DEPTH; first != last && std::next(first) != last; height--) {
+        size_t position = DEPTH - height;
+        Hash256 rightPrefix = withBit(prefix, position);
+        LeafIt middle = leaves.lower_bound(rightPrefix);
+        if (bitAt(key, position)) {
+            proof.siblings.push_back(nodeHash(height - 1, prefix, first, middle, none, none));
+            prefix = rightPrefix;
+            first = middle;
+        } else {
+            proof.siblings.push_back(nodeHash(height - 1, rightPrefix, middle, last, none, none));
+            last = middle;
+        }
+    }
+    proof.hasLeaf = first != last;
+    if (proof.hasLeaf) {
+        proof.leafKey = first->first;
+        proof.leafValue = first->second;
+    }
+    return proof;
+}
+
+bool SparseMerkleTree::verifyProof(const Hash256& key, const Hash256& value, const SparseMerkleProof& proof, const Hash256& rootHash) {
+    size_t depth = proof.siblings.size();
+    if (depth > DEPTH) return false;
+    Hash256 node;
+    if (proof.hasLeaf) {
+        // The leaf must sit in the subtree the proof ends at.
+        if (prefixOf(proof.leafKey, depth) != prefixOf(key, depth)) return false;
+        if (value.empty() ? proof.leafKey == key : (proof.leafKey != key || proof.leafValue != value)) return false;
+        node = leafHash(proof.leafKey, proof.leafValue);
+    } else {
+        if (!value.empty()) return false;
+        node = defaultHash(DEPTH - depth);
+    }
+    for (size_t d = depth; d-- > 0;) {
+        node = bitAt(key, d) ? sha256(proof.siblings[d], node) : sha256(node, proof.siblings[d]);
+    }
+    return node == rootHash;
+}
\ No newline at end of file
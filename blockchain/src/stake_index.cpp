@@ -0,0 +1,110 @@
+#include "stake_index.h"
+#include <stdexcept>
+
+StakeIndex::StakeIndex() : tree(1, 0), total(0) {}
+
+StakeIndex::StakeIndex(const std::vector<Validator>& validators) : total(0) {
+    assign(validators);
+}
+
+void StakeIndex::assign(const std::vector<Validator>& validators) {
+    registry.assign(validators);
+    total = 0;
+    // Linear-time build: push each node's sum into its parent.
+    size_t n = registry.size();
+    tree.assign(n + 1, 0);
+    for (size_t i = 1; i <= n; i++) {
+        tree[i] += registry.stakeAt(i - 1);
+        total += registry.stakeAt(i - 1);
+        size_t parent = i + (i & (~i + 1));
+        if (parent <= n) tree[parent] += tree[i];
+    }
+}
+
+void StakeIndex::add(size_t slot, uint64_t amount) {
+    registry.setStake(slot, registry.stakeAt(slot) + amount);
+    total += amount;
+    for (size_t i = slot + 1; i < tree.size(); i += i & (~i + 1)) tree[i] += amount;
+}
+
+void StakeIndex::subtract(size_t slot, uint64_t amount) {
+    registry.setStake(slot, registry.stakeAt(slot) - amount);
+    total -= amount;
+    for (size_t i = slot + 1; i < tree.size(); i += i & (~i + 1)) tree[i] -= amount;
+}
+
+size_t StakeIndex::slotOf(const std::string& id) const {
+    size_t slot = registry.find(id);
+    if (slot == ValidatorRegistry::NPOS) throw std::out_of_range("StakeIndex: unknown validator " + id);
+    return slot;
+}
+
+void StakeIndex::deposit(const std::string& id, uint64_t amount) {
+    size_t slot = registry.intern(id);
+    if (slot + 1 == tree.size()) {
+        // Appended slot n: its Fenwick node covers (n + 1 - lowbit, n + 1],
+        // i.e. the new stake plus the existing slots below it in that range.
+        size_t i = slot + 1;
+        size_t low = i - (i & (~i + 1));
+        uint64_t node = 0;
+        for (size_t j = i - 1; j > low; j -= j & (~j + 1)) node += tree[j];
+        tree.push_back(node);
+    }
+    add(slot, amount);
+}
+
+void StakeIndex::withdraw(const std::string& id, uint64_t amount) {
+    size_t slot = slotOf(id);
+    if (amount > registry.stakeAt(slot)) throw std::invalid_argument("StakeIndex: withdrawal exceeds stake of " + id);
+    subtract(slot, amount);
+}
+
+uint64_t StakeIndex::slash(const std::string& id, uint64_t amount) {
+    size_t slot = slotOf(id);
+    uint64_t stake = registry.stakeAt(slot);
+    uint64_t taken = amount < stake ? amount : stake;
+    subtract(slot, taken);
+    return taken;
+}
+
+bool StakeIndex::contains(const std::string& id) const {
+    return registry.contains(id);
+}
+
+uint64_t StakeIndex::stakeOf(const std::string& id) const {
+    return registry.stakeAt(slotOf(id));
+}
+
+uint64_t StakeIndex::totalStake() const {
+    return total;
+}
+
+size_t StakeIndex::size() const {
+    return registry.size();
+}
+
+const std::string& StakeIndex::idAt(size_t slot) const {
+    return registry.idAt(slot);
+}
+
+std::vector<Validator> StakeIndex::toValidators() const {
+    return registry.toValidators();
+}
+
+const ValidatorRegistry& StakeIndex::getRegistry() const {
+    return registry;
+}
+
+// Standard Fenwick descent: take the largest steps whose prefix stays <= offset.
+size_t StakeIndex::findByOffset(uint64_t offset) const {
+    size_t position = 0;
+    size_t step = 1;
+    while (step * 2 < tree.size()) step *= 2;
+    for (; step; step /= 2) {
+        if (position + step < tree.size() && tree[position + step] <= offset) {
+            position += step;
+            offset -= tree[position];
+        }
+    }
+    return position;
+}
\ No newline at end of file
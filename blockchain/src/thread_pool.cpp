@@ -0,0 +1,79 @@
+#include "thread_pool.h"
+
+ThreadPool::ThreadPool(unsigned threads) : stopping(false) {
+    if (threads == 0) threads = std::thread::hardware_concurrency();
+    for (unsigned t = 1; t < threads; t++) {
+        workers.push_back(std::thread(&ThreadPool::workerLoop, this));
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    available.notify_all();
+    for (auto& worker : workers) worker.join();
+}
+
+size_t ThreadPool::size() const {
+    return workers.size() + 1;
+}
+
+void ThreadPool::workerLoop() {
+    for (;;) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            available.wait(lock, [this]() { return stopping || !tasks.empty(); });
+            if (tasks.empty()) return;
+            task = std::move(tasks.front());
+            tasks.pop_front();
+        }
+        task();
+    }
+}
+
+void ThreadPool::parallelFor(size_t count, size_t minChunk, const std::function<void(size_t, size_t)>& body) {
+    if (minChunk == 0) minChunk = 1;
+    size_t chunks = count / minChunk;
+    if (chunks > size()) chunks = size();
+    if (chunks <= 1) {
+        if (count) body(0, count);
+        return;
+    }
+
+    // Completion is tracked per call, so several threads may share the pool.
+    struct Pending {
+        std::mutex mutex;
+        std::condition_variable done;
+        size_t remaining;
+    } pending;
+
+    // Rounding the chunk size up can leave fewer chunks than planned.
+    size_t chunkSize = (count + chunks - 1) / chunks;
+    chunks = (count + chunkSize - 1) / chunkSize;
+    pending.remaining = chunks - 1;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (size_t c = 1; c < chunks; c++) {
+            size_t begin = c * chunkSize;
+            size_t end = begin + chunkSize < count ? begin + chunkSize : count;
+            tasks.push_back([&body, &pending, begin, end]() {
+                body(begin, end);
+                std::lock_guard<std::mutex> lock(pending.mutex);
+                if (--pending.remaining == 0) pending.done.notify_one();
+            });
+        }
+    }
+    available.notify_all();
+
+    body(0, chunkSize);
+    std::unique_lock<std::mutex> lock(pending.mutex);
+    pending.done.wait(lock, [&pending]() { return pending.remaining == 0; });
+}
+
+ThreadPool& ThreadPool::shared() {
+    static ThreadPool pool;
+    return pool;
+}
\ No newline at end of file
@@ -1,25 +1,43 @@
 #include "utils.h"
+#include "sha256.h"
 #include <openssl/sha.h>
 #include <sstream>
 #include <iomanip>
 #include <chrono>
+#include <cstring>
+#include <algorithm>
 
 
-std::string sha256(const std::string& input) {
-    unsigned char hash[SHA256_DIGEST_LENGTH];
-    SHA256((unsigned char*)input.c_str(), input.length(), hash);
-    std::stringstream ss;
-    for(int i = 0; i < SHA256_DIGEST_LENGTH; i++) {
-        ss << std::hex << std::setw(2) << std::setfill('0') << (int)hash[i];
-    }
-    return ss.str();
+Hash256 sha256(const std::string& input) {
+    return sha256(input.data(), input.length());
 }
 
-std::string getCurrentTime() {
+Hash256 sha256(const void* data, size_t length) {
+    Hash256 digest;
+    SHA256(static_cast<const unsigned char*>(data), length, digest.data());
+    return digest;
+}
+
+Hash256 sha256(const Hash256& left, const Hash256& right) {
+    unsigned char combined[2 * Hash256::SIZE];
+    std::memcpy(combined, left.data(), Hash256::SIZE);
+    std::memcpy(combined + Hash256::SIZE, right.data(), Hash256::SIZE);
+    return sha256(combined, sizeof(combined));
+}
+
+int64_t currentTimestamp() {
     using namespace std::chrono;
-    auto now = system_clock::now();
-    auto ms = duration_cast<milliseconds>(now.time_since_epoch()) % 1000;
-    std::time_t t = system_clock::to_time_t(now);
+    return duration_cast<milliseconds>(system_clock::now().time_since_epoch()).count();
+}
+
+std::string getCurrentTime() {
+    return formatTimestamp(currentTimestamp());
+}
+
+std::string formatTimestamp(int64_t millis) {
+    int64_t ms = millis % 1000;
+    if (ms < 0) ms += 1000;
+    std::time_t t = static_cast<std::time_t>((millis - ms) / 1000);
     std::tm bt;
 #ifdef _WIN32
     localtime_s(&bt, &t);
@@ -28,6 +46,81 @@ std::string getCurrentTime() {
 #endif
     std::ostringstream oss;
     oss << std::put_time(&bt, "%a %b %d %H:%M:%S");
-    oss << "." << std::setw(3) << std::setfill('0') << ms.count();
+    oss << "." << std::setw(3) << std::setfill('0') << ms;
     return oss.str();
+}
+
+Sha256Hasher::Sha256Hasher() : buffered(0), totalLength(0) {
+    std::memcpy(state, SHA256_INITIAL_STATE, sizeof(state));
+}
+
+Sha256Hasher& Sha256Hasher::update(const void* data, size_t length) {
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    totalLength += length;
+    if (buffered) {
+        size_t take = std::min(length, sizeof(buffer) - buffered);
+        std::memcpy(buffer + buffered, bytes, take);
+        buffered += take;
+        bytes += take;
+        length -= take;
+        if (buffered < sizeof(buffer)) return *this;
+        sha256Compress(state, buffer, 1);
+        buffered = 0;
+    }
+    size_t fullBlocks = length / 64;
+    if (fullBlocks) {
+        sha256Compress(state, bytes, fullBlocks);
+        bytes += fullBlocks * 64;
+        length -= fullBlocks * 64;
+    }
+    if (length) {
+        std::memcpy(buffer, bytes, length);
+        buffered = length;
+    }
+    return *this;
+}
+
+Sha256Hasher& Sha256Hasher::update(const std::string& data) {
+    return update(data.data(), data.size());
+}
+
+Sha256Hasher& Sha256Hasher::update(const Hash256& digest) {
+    return update(digest.data(), Hash256::SIZE);
+}
+
+Sha256Hasher& Sha256Hasher::updateUint32(uint32_t value) {
+    unsigned char bytes[4];
+    for (int i = 0; i < 4; i++) bytes[i] = static_cast<unsigned char>(value >> (8 * i));
+    return update(bytes, sizeof(bytes));
+}
+
+Sha256Hasher& Sha256Hasher::updateUint64(uint64_t value) {
+    unsigned char bytes[8];
+    for (int i = 0; i < 8; i++) bytes[i] = static_cast<unsigned char>(value >> (8 * i));
+    return update(bytes, sizeof(bytes));
+}
+
+Hash256 Sha256Hasher::finalize() const {
+    uint32_t words[8];
+    std::memcpy(words, state, sizeof(words));
+    unsigned char tail[128];
+    size_t tailBlocks = (buffered + 9 <= 64) ? 1 : 2;
+    std::memcpy(tail, buffer, buffered);
+    tail[buffered] = 0x80;
+    std::memset(tail + buffered + 1, 0, tailBlocks * 64 - buffered - 1);
+    uint64_t bits = totalLength * 8;
+    for (int i = 1; i <= 8; i++) {
+        tail[tailBlocks * 64 - i] = static_cast<unsigned char>(bits);
+        bits >>= 8;
+    }
+    sha256Compress(words, tail, tailBlocks);
+
+    Hash256 digest;
+    for (int i = 0; i < 8; i++) {
+        digest.bytes[4 * i] = static_cast<unsigned char>(words[i] >> 24);
+        digest.bytes[4 * i + 1] = static_cast<unsigned char>(words[i] >> 16);
+        digest.bytes[4 * i + 2] = static_cast<unsigned char>(words[i] >> 8);
+        digest.bytes[4 * i + 3] = static_cast<unsigned char>(words[i]);
+    }
+    return digest;
 }
\ No newline at end of file
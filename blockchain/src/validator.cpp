@@ -1,5 +1,7 @@
 #include "validator.h"
 #include "utils.h"
+#include "alias_table.h"
+#include "validator_registry.h"
 #include <random>
 #include <sstream>
 
@@ -20,9 +22,19 @@ std::string Validator::selectValidator(const std::vector<Validator>& validators)
     return validators.back().id;
 }
 
+std::string Validator::selectValidator(const std::vector<Validator>& validators, const AliasTable& selector) {
+    static thread_local std::mt19937_64 gen{std::random_device()()};
+    return validators[selector.sample(gen)].id;
+}
+
 bool Validator::validateStake(const std::vector<Validator>& validators, const std::string& selectedId) {
     for (const auto& v : validators) {
         if (v.id == selectedId && v.stake > 0) return true;
     }
     return false;
+}
+
+bool Validator::validateStake(const ValidatorRegistry& registry, const std::string& selectedId) {
+    size_t slot = registry.find(selectedId);
+    return slot != ValidatorRegistry::NPOS && registry.stakeAt(slot) > 0;
 }
\ No newline at end of file
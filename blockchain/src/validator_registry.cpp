@@ -0,0 +1,108 @@
+#include "validator_registry.h"
+#include <limits>
+
+const size_t ValidatorRegistry::NPOS;
+
+ValidatorRegistry::ValidatorRegistry() {}
+
+ValidatorRegistry::ValidatorRegistry(const std::vector<Validator>& validators) {
+    assign(validators);
+}
+
+void ValidatorRegistry::assign(const std::vector<Validator>& validators) {
+    clear();
+    ids.reserve(validators.size());
+    hashes.reserve(validators.size());
+    stakes.reserve(validators.size());
+    for (const auto& v : validators) {
+        setStake(intern(v.id), v.stake > 0 ? static_cast<uint64_t>(v.stake) : 0);
+    }
+}
+
+void ValidatorRegistry::clear() {
+    ids.clear();
+    hashes.clear();
+    stakes.clear();
+    buckets.clear();
+}
+
+// FNV-1a: cheap on short ids, and independent of the standard library so
+// the table layout is the same everywhere.
+uint64_t ValidatorRegistry::hashId(const std::string& id) {
+    uint64_t hash = 14695981039346656037ULL;
+    for (unsigned char c : id) {
+        hash ^= c;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+// Bucket holding `id`, or the empty bucket where it would go. The stored
+// hashes let most mismatches skip the string comparison.
+size_t ValidatorRegistry::probe(const std::string& id, uint64_t hash) const {
+    size_t mask = buckets.size() - 1;
+    for (size_t i = static_cast<size_t>(hash) & mask;; i = (i + 1) & mask) {
+        uint32_t entry = buckets[i];
+        if (entry == 0) return i;
+        if (hashes[entry - 1] == hash && ids[entry - 1] == id) return i;
+    }
+}
+
+void ValidatorRegistry::grow() {
+    size_t capacity = buckets.empty() ? 16 : buckets.size() * 2;
+    buckets.assign(capacity, 0);
+    size_t mask = capacity - 1;
+    for (size_t slot = 0; slot < ids.size(); slot++) {
+        size_t i = static_cast<size_t>(hashes[slot]) & mask;
+        while (buckets[i] != 0) i = (i + 1) & mask;
+        buckets[i] = static_cast<uint32_t>(slot + 1);
+    }
+}
+
+size_t ValidatorRegistry::intern(const std::string& id) {
+    if ((ids.size() + 1) * 2 > buckets.size()) grow();
+    uint64_t hash = hashId(id);
+    size_t bucket = probe(id, hash);
+    if (buckets[bucket] != 0) return buckets[bucket] - 1;
+    buckets[bucket] = static_cast<uint32_t>(ids.size() + 1);
+    ids.push_back(id);
+    hashes.push_back(hash);
+    stakes.push_back(0);
+    return ids.size() - 1;
+}
+
+size_t ValidatorRegistry::find(const std::string& id) const {
+    if (buckets.empty()) return NPOS;
+    uint32_t entry = buckets[probe(id, hashId(id))];
+    return entry == 0 ? NPOS : entry - 1;
+}
+
+bool ValidatorRegistry::contains(const std::string& id) const {
+    return find(id) != NPOS;
+}
+
+size_t ValidatorRegistry::size() const {
+    return ids.size();
+}
+
+const std::string& ValidatorRegistry::idAt(size_t slot) const {
+    return ids[slot];
+}
+
+uint64_t ValidatorRegistry::stakeAt(size_t slot) const {
+    return stakes[slot];
+}
+
+void ValidatorRegistry::setStake(size_t slot, uint64_t stake) {
+    stakes[slot] = stake;
+}
+
+std::vector<Validator> ValidatorRegistry::toValidators() const {
+    std::vector<Validator> validators;
+    validators.reserve(ids.size());
+    const uint64_t maxStake = static_cast<uint64_t>(std::numeric_limits<int>::max());
+    for (size_t i = 0; i < ids.size(); i++) {
+        validators.push_back(Validator(ids[i], static_cast<int>(stakes[i] < maxStake ? stakes[i] : maxStake)));
+    }
+    return validators;
+}
\ No newline at end of file
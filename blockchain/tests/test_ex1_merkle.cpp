@@ -1,7 +1,17 @@
 #include "merkle_tree.h"
+#include "sha256.h"
+#include "utils.h"
+#include "thread_pool.h"
+#include "merkle_accumulator.h"
+#include "merkle_mountain_range.h"
+#include "kary_merkle_tree.h"
 #include <vector>
 #include <iostream>
 #include <cassert>
+#include <stdexcept>
+#include <sstream>
+#include <fstream>
+#include <cstdio>
 
 int main() {
     std::vector<std::string> transactions = {
@@ -11,9 +21,211 @@ int main() {
     };
     MerkleTree merkleTree(transactions);
     assert(!merkleTree.getRootHash().empty());
+    assert(Hash256::fromHex(merkleTree.getRootHash().toHex()) == merkleTree.getRootHash());
     merkleTree.printTree();
     std::cout << "Merkle Tree Test Passed: Root Hash generated and tree printed.\n";
     assert(merkleTree.verifyTransaction("Tx1: Alice->Bob:50"));
     std::cout << "Merkle Tree Test Passed: Transaction verification works.\n";
+
+    // The flat level array must reproduce the pairwise definition, including
+    // the duplicated last node of odd levels.
+    for (size_t count = 1; count <= 33; count++) {
+        std::vector<std::string> txs;
+        for (size_t i = 0; i < count; i++) txs.push_back("tx" + std::to_string(i));
+        std::vector<Hash256> level;
+        for (const auto& tx : txs) level.push_back(sha256(tx));
+        size_t levels = 1;
+        while (level.size() > 1) {
+            std::vector<Hash256> parents;
+            for (size_t i = 0; i < level.size(); i += 2) {
+                parents.push_back(sha256(level[i], level[i + 1 < level.size() ? i + 1 : i]));
+            }
+            level.swap(parents);
+            levels++;
+        }
+        MerkleTree tree(txs);
+        assert(tree.getRootHash() == level[0]);
+        assert(tree.getLeafCount() == count && tree.getLevelCount() == levels);
+        assert(tree.verifyTransaction(txs[count - 1]) && !tree.verifyTransaction("missing"));
+        for (size_t i = 0; i < count; i++) {
+            MerkleProof proof = tree.getProof(i);
+            assert(proof.siblings.size() == levels - 1);
+            assert(MerkleTree::verifyProof(txs[i], proof, level[0]));
+            assert(!MerkleTree::verifyProof(txs[(i + 1) % count] + "x", proof, level[0]));
+        }
+    }
+    assert(MerkleTree(std::vector<std::string>()).getRootHash().empty());
+    bool threw = false;
+    try {
+        merkleTree.getProof(transactions.size());
+    } catch (const std::out_of_range&) {
+        threw = true;
+    }
+    assert(threw);
+    std::cout << "Merkle Tree Test Passed: Level array matches the pairwise construction.\n";
+    std::cout << "Merkle Tree Test Passed: Inclusion proofs verify against the root.\n";
+
+    // Indexed lookups answer the same as the scan, first position for duplicates.
+    std::vector<std::string> withDuplicate = {"a", "b", "c", "b", "d"};
+    MerkleTree indexed(withDuplicate);
+    assert(!indexed.hasLeafIndex());
+    indexed.buildLeafIndex();
+    assert(indexed.hasLeafIndex());
+    size_t found = 0;
+    assert(indexed.findLeaf(sha256(std::string("b")), found) && found == 1);
+    assert(indexed.findLeaf(sha256(std::string("d")), found) && found == 4);
+    assert(indexed.verifyTransaction("c") && !indexed.verifyTransaction("e"));
+    assert(MerkleTree::verifyProof(std::string("d"), indexed.getProof(found), indexed.getRootHash()));
+    std::cout << "Merkle Tree Test Passed: Leaf index lookups.\n";
+
+    // Multiproofs carry fewer hashes than separate paths and verify as a set.
+    std::vector<std::string> wallet;
+    for (size_t i = 0; i < 37; i++) wallet.push_back("wallet-tx" + std::to_string(i));
+    MerkleTree walletTree(wallet);
+    std::vector<std::vector<size_t>> selections = {{0}, {36}, {3, 4}, {35, 36}, {36, 1, 1, 17, 2}, {}};
+    std::vector<size_t> everyThird;
+    for (size_t i = 0; i < wallet.size(); i += 3) everyThird.push_back(i);
+    selections.push_back(everyThird);
+    for (const auto& selection : selections) {
+        MerkleMultiProof multi = walletTree.getMultiProof(selection);
+        std::vector<Hash256> leaves;
+        for (size_t i : multi.indices) leaves.push_back(sha256(wallet[i]));
+        assert(MerkleTree::verifyMultiProof(leaves, multi, walletTree.getRootHash()) == !selection.empty());
+        if (multi.indices.size() > 1) {
+            assert(multi.hashes.size() < multi.indices.size() * walletTree.getProof(0).siblings.size());
+            leaves[1] = sha256(std::string("forged"));
+            assert(!MerkleTree::verifyMultiProof(leaves, multi, walletTree.getRootHash()));
+        }
+    }
+    std::cout << "Merkle Tree Test Passed: Multiproofs verify with shared siblings.\n";
+
+    // Mountain range proofs stay valid for every leaf at every size, and old
+    // proofs fail against a newer root.
+    MerkleMountainRange mmr;
+    assert(mmr.getRootHash().empty());
+    for (uint64_t n = 1; n <= 40; n++) {
+        Hash256 previousRoot = mmr.getRootHash();
+        mmr.append(sha256("block" + std::to_string(n - 1)));
+        assert(mmr.size() == n && mmr.getRootHash() != previousRoot && mmr.getRootHash(n - 1) == previousRoot);
+        for (uint64_t i = 0; i < n; i++) {
+            MmrProof proof = mmr.getProof(i);
+            assert(MerkleMountainRange::verifyProof(sha256("block" + std::to_string(i)), proof, mmr.getRootHash()));
+            if (i + 1 < n) {
+                assert(!MerkleMountainRange::verifyProof(sha256("block" + std::to_string(i)), proof, previousRoot));
+                assert(MerkleMountainRange::verifyProof(sha256("block" + std::to_string(i)), mmr.getProof(i, n - 1), previousRoot));
+            }
+        }
+    }
+    std::cout << "Merkle Tree Test Passed: Mountain range proofs for every leaf.\n";
+
+    // MerkleTree and KaryMerkleTree share one level builder: the binary
+    // instance matches MerkleTree node for node and proof for proof; wider
+    // trees are shallower and their proofs verify for every leaf, including
+    // padded last groups.
+    for (size_t count = 1; count <= 70; count += 3) {
+        std::vector<std::string> txs;
+        for (size_t i = 0; i < count; i++) txs.push_back("kary-tx" + std::to_string(i));
+        MerkleTree binaryTree(txs);
+        KaryMerkleTree<2> binary(txs);
+        assert(binary.getRootHash() == binaryTree.getRootHash() && binary.getLevelCount() == binaryTree.getLevelCount());
+        KaryMerkleTree<4> quad(txs);
+        KaryMerkleTree<8> oct(txs);
+        assert(oct.getLevelCount() <= quad.getLevelCount());
+        for (size_t i = 0; i < count; i++) {
+            KaryMerkleProof binaryProof = binary.getProof(i);
+            assert(binaryProof.siblings == binaryTree.getProof(i).siblings);
+            assert(KaryMerkleTree<2>::verifyProof(sha256(txs[i]), binaryProof, binaryTree.getRootHash()));
+            assert(KaryMerkleTree<4>::verifyProof(sha256(txs[i]), quad.getProof(i), quad.getRootHash()));
+            KaryMerkleProof proof = oct.getProof(i);
+            assert(KaryMerkleTree<8>::verifyProof(sha256(txs[i]), proof, oct.getRootHash()));
+            assert(!KaryMerkleTree<8>::verifyProof(sha256(txs[i] + "x"), proof, oct.getRootHash()));
+        }
+    }
+    std::cout << "Merkle Tree Test Passed: 2-, 4- and 8-ary trees.\n";
+
+    // Parallel builds split wide levels across the pool but must produce the
+    // same tree as a serial build, odd levels included.
+    ThreadPool serialPool(1);
+    ThreadPool parallelPool(4);
+    std::vector<size_t> visits(10007, 0);
+    parallelPool.parallelFor(visits.size(), 100, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) visits[i]++;
+    });
+    for (size_t v : visits) assert(v == 1);
+    // 11 items over 5 threads round up to chunks of 3, i.e. only 4 chunks.
+    ThreadPool fivePool(5);
+    std::vector<size_t> few(11, 0);
+    fivePool.parallelFor(few.size(), 2, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) few[i]++;
+    });
+    for (size_t v : few) assert(v == 1);
+    std::vector<std::string> bigBlock;
+    for (size_t i = 0; i < 4 * MerkleTree::MIN_PARALLEL_CHUNK + 3; i++) bigBlock.push_back("big-tx" + std::to_string(i));
+    MerkleTree serialTree(bigBlock, serialPool);
+    MerkleTree parallelTree(bigBlock, parallelPool);
+    assert(parallelTree.getRootHash() == serialTree.getRootHash());
+    assert(MerkleTree(bigBlock).getRootHash() == serialTree.getRootHash());
+    for (size_t level = 0; level < serialTree.getLevelCount(); level++) {
+        for (size_t i = 0; i < serialTree.getLevelSize(level); i++) {
+            assert(parallelTree.getNode(level, i) == serialTree.getNode(level, i));
+        }
+    }
+    std::cout << "Merkle Tree Test Passed: Parallel build matches the serial tree.\n";
+
+    // The accumulator tracks the same root as a full rebuild after every append.
+    MerkleAccumulator accumulator;
+    assert(accumulator.getRootHash().empty());
+    std::vector<std::string> grown;
+    for (size_t i = 0; i < 70; i++) {
+        grown.push_back("acc-tx" + std::to_string(i));
+        accumulator.append(grown.back());
+        assert(accumulator.size() == grown.size());
+        assert(accumulator.getRootHash() == MerkleTree(grown).getRootHash());
+    }
+    std::cout << "Merkle Tree Test Passed: Incremental accumulator matches the full tree.\n";
+
+    // Streaming roots: iterator range, stream and file inputs, spanning
+    // several internal batches and including an empty transaction.
+    std::vector<std::string> archive;
+    for (size_t i = 0; i < 2500; i++) archive.push_back(i == 1500 ? "" : "archived-tx" + std::to_string(i));
+    Hash256 archiveRoot = MerkleTree(archive).getRootHash();
+    std::string text;
+    for (const auto& tx : archive) text += tx + "\n";
+    MerkleAccumulator fromRange;
+    fromRange.appendRange(archive.begin(), archive.end());
+    assert(fromRange.getRootHash() == archiveRoot);
+    MerkleAccumulator fromStream;
+    std::istringstream stream(text.substr(0, text.size() - 1));
+    assert(fromStream.appendLines(stream) == archive.size());
+    assert(fromStream.getRootHash() == archiveRoot);
+    const char* archivePath = "merkle_stream_test.txt";
+    {
+        std::ofstream out(archivePath, std::ios::binary);
+        out << text;
+    }
+    MerkleAccumulator fromFile;
+    assert(fromFile.appendFile(archivePath) == archive.size());
+    assert(fromFile.getRootHash() == archiveRoot);
+    std::remove(archivePath);
+    std::cout << "Merkle Tree Test Passed: Streaming roots match the in-memory tree.\n";
+
+    // Every SHA-256 backend the CPU supports must agree with the scalar path.
+    const Sha256Backend backends[] = {SHA256_BACKEND_SCALAR, SHA256_BACKEND_AVX2, SHA256_BACKEND_SHANI};
+    Sha256Backend detected = sha256Backend();
+    std::vector<std::string> messages;
+    for (size_t len = 0; len < 200; len += 7) messages.push_back(std::string(len, static_cast<char>('a' + len % 26)));
+    for (Sha256Backend backend : backends) {
+        if (!setSha256Backend(backend)) continue;
+        std::vector<Hash256> digests = sha256_batch(messages);
+        for (size_t i = 0; i < messages.size(); i++) assert(digests[i] == sha256(messages[i]));
+        assert(MerkleTree(transactions).getRootHash() == merkleTree.getRootHash());
+        Sha256Hasher hasher;
+        for (const auto& m : messages) hasher.update(m);
+        std::string joined;
+        for (const auto& m : messages) joined += m;
+        assert(hasher.finalize() == sha256(joined));
+        std::cout << "Merkle Tree Test Passed: sha256_batch matches on " << sha256BackendName(backend) << ".\n";
+    }
+    setSha256Backend(detected);
     return 0;
 }
\ No newline at end of file
@@ -1,8 +1,14 @@
 #include "blockchain_pow.h"
 #include "transaction.h"
+#include "pow.h"
+#include "utils.h"
 #include <vector>
 #include <iostream>
 #include <cassert>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <stdexcept>
 
 int main() {
     BlockchainPow powChain(2);
@@ -15,5 +21,119 @@ int main() {
     powChain.displayChain();
     assert(powChain.isChainValid());
     std::cout << "PoW Test Passed: Chain is valid with different difficulties.\n";
+
+    // Parallel search must report the same (lowest) nonce as the serial scan.
+    BlockHeader header;
+    header.height = 42;
+    header.merkleRoot = sha256(std::string("parallel"));
+    // Fixed inputs: a chain-dependent parent could hit below the wrap point.
+    header.previousHash = sha256(std::string("parallel-parent"));
+    header.timestamp = 1700000000000LL;
+    header.bits = ProofOfWork::compactFromTarget(ProofOfWork::targetFromZeroBits(12));
+    // Starting just below 2^64 forces the nonce to wrap into the extra-nonce.
+    const uint64_t nearWrap = UINT64_MAX - 100;
+    header.nonce = nearWrap;
+    BlockHeader serial = header;
+    Hash256 serialHash = ProofOfWork::mineBlock(serial);
+    assert(serial.extraNonce == 1 && serial.nonce < nearWrap);
+    BlockHeader parallel = header;
+    Hash256 parallelHash = ProofOfWork::mineBlock(parallel, MiningOptions(4, true));
+    assert(parallel.nonce == serial.nonce && parallel.extraNonce == serial.extraNonce && parallelHash == serialHash);
+    BlockHeader first = header;
+    first.nonce = 0;
+    Hash256 firstHash = ProofOfWork::mineBlock(first, MiningOptions(4, false));
+    assert(ProofOfWork::verifyBlock(first, firstHash));
+    first.timestamp++;
+    assert(!ProofOfWork::verifyBlock(first, firstHash));
+
+    powChain.setMiningOptions(MiningOptions(4));
+    powChain.addBlock(txStrings);
+    assert(powChain.isChainValid());
+    std::cout << "PoW Test Passed: Parallel nonce search matches the serial result.\n";
+
+    // Bit-level targets: 10 zero bits sits between hex difficulties 2 and 3.
+    Hash256 tenBits = ProofOfWork::targetFromZeroBits(10);
+    assert(ProofOfWork::leadingZeroBits(tenBits) == 10);
+    assert(ProofOfWork::meetsTarget(tenBits, tenBits));
+    assert(!ProofOfWork::meetsTarget(ProofOfWork::targetFromZeroBits(9), tenBits));
+    powChain.setDifficultyBits(10);
+    powChain.addBlock(txStrings);
+    assert(ProofOfWork::leadingZeroBits(powChain.getLatestHash()) >= 10);
+    assert(powChain.isChainValid());
+    std::cout << "PoW Test Passed: Bit-level difficulty targets.\n";
+
+    // Headers have one fixed binary encoding, and targets survive the compact form.
+    unsigned char bytes[BlockHeader::SIZE];
+    serial.serialize(bytes);
+    BlockHeader decoded = BlockHeader::deserialize(bytes);
+    assert(decoded.hash() == serialHash && decoded.nonce == serial.nonce && decoded.extraNonce == 1);
+    serial.stateRoot = sha256(std::string("state"));
+    serial.serialize(bytes);
+    assert(BlockHeader::deserialize(bytes).stateRoot == serial.stateRoot && serial.hash() != serialHash);
+    assert(serial.hashWithProposer("V1") != serial.hashWithProposer("V2"));
+    assert(decoded.timestamp == header.timestamp && decoded.height == 42);
+    assert(ProofOfWork::compactFromTarget(ProofOfWork::targetFromZeroBits(12)) == 0x1f0fffff);
+    for (int bits = 0; bits <= 255; bits += 5) {
+        Hash256 t = ProofOfWork::targetFromCompact(ProofOfWork::compactFromTarget(ProofOfWork::targetFromZeroBits(bits)));
+        assert(ProofOfWork::leadingZeroBits(t) == bits);
+        assert(ProofOfWork::compactFromTarget(t) == ProofOfWork::compactFromTarget(ProofOfWork::targetFromZeroBits(bits)));
+    }
+    std::cout << "PoW Test Passed: Block header encoding and compact targets.\n";
+
+    // Background mining: the chain answers queries while the job runs.
+    MiningOptions asyncOptions(2);
+    asyncOptions.progressInterval = std::chrono::milliseconds(5);
+    powChain.setMiningOptions(asyncOptions);
+    MiningHandle job = powChain.submitMiningJob(txStrings);
+    assert(powChain.isChainValid());
+    assert(powChain.commitMiningJob(job));
+    assert(powChain.isChainValid());
+
+    // A job that cannot finish reports progress, then goes stale when a
+    // competing block lands on the tip.
+    std::atomic<int> reports(0);
+    powChain.setDifficultyBits(96);
+    MiningHandle stale = powChain.submitMiningJob(txStrings, [&](const MiningProgress&) { reports++; });
+    while (reports.load() == 0) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    assert(stale.progress().attempts > 0);
+    powChain.setDifficultyBits(8);
+    powChain.addBlock(txStrings);
+    assert(stale.cancelled());
+    assert(!powChain.commitMiningJob(stale));
+
+    MiningHandle dropped = powChain.submitMiningJob(txStrings);
+    dropped.cancel();
+    assert(!powChain.commitMiningJob(dropped));
+    assert(powChain.isChainValid());
+    // Blocks must carry the target configured for their height, so a job
+    // mined against an outdated target is refused.
+    MiningHandle retargeted = powChain.submitMiningJob(txStrings);
+    powChain.setDifficultyBits(12);
+    assert(retargeted.cancelled() && !powChain.commitMiningJob(retargeted));
+    powChain.addBlock(txStrings);
+    assert(powChain.isChainValid());
+    // The target schedule is kept with the chain, one entry per real change,
+    // and every header commits to it up to its own height.
+    std::vector<std::pair<uint64_t, uint32_t>> changes = powChain.getTargetChanges();
+    uint64_t retargetHeight = changes.back().first;
+    assert(changes.front().first == 0 && powChain.getHeader(retargetHeight).bits == changes.back().second);
+    assert(powChain.getHeader(retargetHeight).stateRoot == BlockchainPow::commitTargetChanges(changes, retargetHeight));
+    assert(powChain.getHeader(retargetHeight).stateRoot != powChain.getHeader(retargetHeight - 1).stateRoot);
+    powChain.setDifficultyBits(12);
+    assert(powChain.getTargetChanges() == changes);
+    powChain.setDifficultyBits(16);
+    powChain.setDifficultyBits(12);
+    assert(powChain.getTargetChanges() == changes);
+    std::vector<std::pair<uint64_t, uint32_t>> rewritten = changes;
+    rewritten[1].second ^= 1;
+    assert(BlockchainPow::commitTargetChanges(rewritten, retargetHeight) != powChain.getHeader(retargetHeight).stateRoot);
+    bool emptyRejected = false;
+    try {
+        MiningHandle().get();
+    } catch (const std::logic_error&) {
+        emptyRejected = true;
+    }
+    assert(emptyRejected);
+    std::cout << "PoW Test Passed: Asynchronous mining jobs, progress and cancellation.\n";
     return 0;
 }
\ No newline at end of file
@@ -3,6 +3,16 @@
 #include "transaction.h"
 #include "validator.h"
 #include "utils.h"
+#include "sparse_merkle_tree.h"
+#include "alias_table.h"
+#include "stake_index.h"
+#include "validator_registry.h"
+#include "pos.h"
+#include <map>
+#include <stdexcept>
+#include <cmath>
+#include <limits>
+#include <random>
 #include <vector>
 #include <iostream>
 #include <cassert>
@@ -19,6 +29,216 @@ int main() {
     assert(posChain.isChainValid());
     std::cout << "PoS Test Passed: Chain is valid.\n";
 
+    // Alias sampling follows the stake distribution and skips zero stake.
+    std::vector<Validator> weighted = {{"A", 50}, {"B", 0}, {"C", 30}, {"D", 20}, {"E", 0}};
+    AliasTable table(weighted);
+    assert(table.size() == weighted.size() && !table.empty());
+    assert(AliasTable(std::vector<Validator>{{"Z", 0}}).empty());
+    std::mt19937_64 gen(7);
+    std::vector<int> draws(weighted.size(), 0);
+    const int samples = 200000;
+    for (int i = 0; i < samples; i++) draws[table.sample(gen)]++;
+    assert(draws[1] == 0 && draws[4] == 0);
+    for (size_t i = 0; i < weighted.size(); i++) {
+        assert(std::fabs(draws[i] / double(samples) - weighted[i].stake / 100.0) < 0.01);
+    }
+    std::string picked = Validator::selectValidator(weighted, table);
+    assert(picked == "A" || picked == "C" || picked == "D");
+    bool emptyRejected = false;
+    try {
+        Validator::selectValidator(std::vector<Validator>(), AliasTable(std::vector<Validator>()));
+    } catch (const std::logic_error&) {
+        emptyRejected = true;
+    }
+    assert(emptyRejected);
+    std::cout << "PoS Test Passed: Alias table sampling matches stakes.\n";
+
+    // Fenwick stake index: offsets map onto the stakes laid end to end, and
+    // updates keep sums and draws consistent.
+    StakeIndex index(weighted);
+    assert(index.totalStake() == 100 && index.size() == 5);
+    assert(index.findByOffset(0) == 0 && index.findByOffset(49) == 0);
+    assert(index.findByOffset(50) == 2 && index.findByOffset(79) == 2 && index.findByOffset(80) == 3);
+    index.deposit("B", 25);
+    index.slash("A", 30);
+    index.withdraw("D", 20);
+    for (int i = 0; i < 40; i++) index.deposit("N" + std::to_string(i), i % 3);
+    assert(index.stakeOf("A") == 20 && index.stakeOf("B") == 25 && index.stakeOf("D") == 0);
+    assert(index.slash("C", 1000) == 30 && index.stakeOf("C") == 0);
+    uint64_t expectedTotal = 45;
+    for (int i = 0; i < 40; i++) expectedTotal += i % 3;
+    assert(index.totalStake() == expectedTotal);
+    uint64_t offset = 0;
+    for (size_t slot = 0; slot < index.size(); slot++) {
+        uint64_t stake = index.stakeOf(index.idAt(slot));
+        if (stake) assert(index.findByOffset(offset) == slot && index.findByOffset(offset + stake - 1) == slot);
+        offset += stake;
+    }
+    bool rejected = false;
+    try {
+        index.withdraw("A", 21);
+    } catch (const std::invalid_argument&) {
+        rejected = true;
+    }
+    assert(rejected && index.stakeOf("A") == 20);
+
+    Hash256 rootBefore = posChain.getStateRoot();
+    posChain.deposit("V3", 10);
+    posChain.slash("V1", 5);
+    assert(posChain.getStake("V3") == 30 && posChain.getStake("V1") == 45);
+    assert(posChain.getStake("nobody") == 0);
+    assert(posChain.getStateRoot() != rootBefore);
+    assert(SparseMerkleTree::verifyProof(SparseMerkleTree::keyFor("V1"), BlockchainPos::stakeValue("V1", 45),
+                                         posChain.getStakeProof("V1"), posChain.getStateRoot()));
+    posChain.addBlock(txStrings);
+    assert(posChain.isChainValid());
+    std::cout << "PoS Test Passed: Fenwick stake index updates and sampling.\n";
+
+    // The registry hands out dense slots and finds them by hash, through
+    // several table growths; stake checks agree with the linear scan.
+    std::vector<Validator> many;
+    for (int i = 0; i < 1000; i++) many.push_back(Validator("R" + std::to_string(i), i % 3));
+    ValidatorRegistry registry(many);
+    assert(registry.size() == 1000);
+    for (int i = 0; i < 1000; i++) {
+        std::string id = "R" + std::to_string(i);
+        assert(registry.find(id) == size_t(i) && registry.idAt(i) == id);
+        assert(Validator::validateStake(registry, id) == Validator::validateStake(many, id));
+    }
+    assert(registry.find("R1000") == ValidatorRegistry::NPOS && !Validator::validateStake(registry, "R1000"));
+    assert(registry.intern("R7") == 7 && registry.intern("new") == 1000);
+    registry.setStake(registry.find("R3"), 5);
+    assert(Validator::validateStake(registry, "R3") && registry.stakeAt(3) == 5);
+    assert(ValidatorRegistry(std::vector<Validator>{{"D", 1}, {"D", 4}}).toValidators().size() == 1);
+    registry.setStake(0, 5000000000ULL);
+    assert(registry.stakeAt(0) == 5000000000ULL && registry.toValidators()[0].stake == std::numeric_limits<int>::max());
+    assert(Validator::validateStake(index.getRegistry(), "B") && !Validator::validateStake(index.getRegistry(), "D"));
+    std::cout << "PoS Test Passed: Hash-indexed validator registry.\n";
+
+    // Proposers are a pure function of (previous hash, slot, stakes), so
+    // anyone can recompute them, and across slots they follow the stakes.
+    StakeIndex proposers(std::vector<Validator>{{"P1", 60}, {"P2", 30}, {"P3", 10}, {"P0", 0}});
+    Hash256 parent = sha256(std::string("parent"));
+    assert(ProofOfStake::selectProposer(parent, 5, proposers) == ProofOfStake::selectProposer(parent, 5, proposers));
+    ProposerRng first(parent, 5), second(parent, 5);
+    for (int i = 0; i < 10; i++) assert(first() == second());
+    for (int i = 0; i < 1000; i++) assert(first.nextBelow(7) < 7);
+    std::map<std::string, int> wins;
+    const int slots = 20000;
+    for (int slot = 0; slot < slots; slot++) wins[ProofOfStake::selectProposer(parent, slot, proposers)]++;
+    assert(wins.count("P0") == 0);
+    assert(std::fabs(wins["P1"] / double(slots) - 0.6) < 0.02 && std::fabs(wins["P3"] / double(slots) - 0.1) < 0.02);
+    assert(ProofOfStake::selectProposer(parent, 0, StakeIndex()).empty());
+    for (int i = 0; i < 5; i++) posChain.addBlock(txStrings);
+    assert(posChain.isChainValid());
+    std::cout << "PoS Test Passed: Deterministic proposer selection.\n";
+
+    // Epoch schedules fix every slot's proposer up front; a stake change
+    // only shows up from the epoch after the block that commits it, and
+    // every schedule can be rebuilt from the boundary block alone.
+    ProposerSchedule schedule = ProposerSchedule::build(parent, 64, 32, proposers);
+    assert(schedule.covers(64) && schedule.covers(95) && !schedule.covers(63) && !schedule.covers(96));
+    ProposerSchedule again = ProposerSchedule::build(parent, 64, 32, proposers);
+    for (uint64_t slot = 64; slot < 96; slot++) {
+        assert(schedule.proposerAt(slot) == again.proposerAt(slot) && schedule.proposerAt(slot) != "P0");
+    }
+    assert(ProposerSchedule::build(parent, 0, 32, StakeIndex()).empty());
+    BlockchainPos epochChain(2, {{"E1", 50}, {"E2", 50}}, 4);
+    for (int i = 0; i < 6; i++) epochChain.addBlock(txStrings);
+    std::vector<std::string> planned;
+    for (uint64_t slot = 4; slot < 8; slot++) planned.push_back(epochChain.getProposer(slot));
+    assert(!planned[3].empty() && epochChain.getProposer(8).empty());
+    epochChain.deposit("E3", 1000000000);
+    for (uint64_t slot = 4; slot < 8; slot++) assert(epochChain.getProposer(slot) == planned[slot - 4]);
+    for (int i = 0; i < 2; i++) epochChain.addBlock(txStrings);
+    for (uint64_t slot = 8; slot < 12; slot++) assert(epochChain.getProposer(slot) == "E3");
+    const StakeSnapshot& nextStakes = epochChain.getEpochStakes(2);
+    assert(nextStakes.ids.size() == 3 && epochChain.getEpochStakes(1).ids.size() == 2);
+    assert(BlockchainPos::verifyStakeSnapshot(nextStakes, epochChain.getHeader(7).stateRoot));
+    assert(!BlockchainPos::verifyStakeSnapshot(epochChain.getEpochStakes(1), epochChain.getHeader(7).stateRoot));
+    StakeSnapshot forged = nextStakes;
+    forged.stakes[0] += 1;
+    assert(!BlockchainPos::verifyStakeSnapshot(forged, epochChain.getHeader(7).stateRoot));
+    forged = nextStakes;
+    std::swap(forged.ids[0], forged.ids[1]);
+    std::swap(forged.stakes[0], forged.stakes[1]);
+    assert(!BlockchainPos::verifyStakeSnapshot(forged, epochChain.getHeader(7).stateRoot));
+    ProposerSchedule rebuilt = ProposerSchedule::build(epochChain.getHeader(8).previousHash, 8, 4, nextStakes.toIndex());
+    for (uint64_t slot = 8; slot < 12; slot++) assert(rebuilt.proposerAt(slot) == epochChain.getProposer(slot));
+    bool unscheduled = false;
+    try {
+        epochChain.getEpochStakes(4);
+    } catch (const std::out_of_range&) {
+        unscheduled = true;
+    }
+    assert(unscheduled);
+    assert(epochChain.isChainValid());
+    std::cout << "PoS Test Passed: Epoch proposer schedules.\n";
+
+    // Sparse Merkle tree: the root depends only on the contents, whatever
+    // the order or batching of updates, and proofs cover absent keys too.
+    SparseMerkleTree state;
+    assert(state.getRootHash() == SparseMerkleTree::defaultHash(SparseMerkleTree::DEPTH));
+    std::vector<std::pair<Hash256, Hash256>> accounts;
+    for (int i = 0; i < 300; i++) {
+        accounts.push_back(std::make_pair(SparseMerkleTree::keyFor("acct" + std::to_string(i)), sha256("balance" + std::to_string(i))));
+    }
+    SparseMerkleTree batched;
+    batched.update(accounts);
+    for (size_t i = accounts.size(); i-- > 0;) {
+        state.update(accounts[i].first, accounts[i].second);
+        if (i % 50 == 0) state.getRootHash();
+    }
+    assert(state.getRootHash() == batched.getRootHash() && state.size() == 300);
+    Hash256 fullRoot = state.getRootHash();
+    Hash256 extra = SparseMerkleTree::keyFor("extra");
+    state.update(extra, sha256(std::string("x")));
+    assert(state.getRootHash() != fullRoot);
+    state.update(extra, Hash256());
+    assert(state.getRootHash() == fullRoot);
+    for (size_t i = 0; i < accounts.size(); i += 37) {
+        SparseMerkleProof proof = state.getProof(accounts[i].first);
+        assert(proof.siblings.size() < 32);
+        assert(SparseMerkleTree::verifyProof(accounts[i].first, accounts[i].second, proof, fullRoot));
+        assert(!SparseMerkleTree::verifyProof(accounts[i].first, sha256(std::string("forged")), proof, fullRoot));
+        assert(!SparseMerkleTree::verifyProof(accounts[i].first, Hash256(), proof, fullRoot));
+    }
+    // Deleting and reinserting leaves no stale cached nodes behind, also when
+    // a batch collapses whole subtrees down to one leaf.
+    size_t fullCache = state.getCacheSize();
+    assert(fullCache > 0);
+    for (int cycle = 0; cycle < 3; cycle++) {
+        std::vector<std::pair<Hash256, Hash256>> removals;
+        for (size_t i = cycle == 2 ? 1 : cycle; i < accounts.size(); i += cycle == 2 ? 1 : 2) {
+            removals.push_back(std::make_pair(accounts[i].first, Hash256()));
+        }
+        state.update(removals);
+        if (cycle == 2) assert(state.getCacheSize() == 0 && state.size() == 1);
+        state.update(accounts);
+        assert(state.getCacheSize() == fullCache && state.getRootHash() == fullRoot);
+    }
+    SparseMerkleProof absent = state.getProof(extra);
+    assert(SparseMerkleTree::verifyProof(extra, Hash256(), absent, fullRoot));
+    assert(!SparseMerkleTree::verifyProof(extra, sha256(std::string("x")), absent, fullRoot));
+    // Keys that differ in their first bit sit directly under the root.
+    SparseMerkleTree pair;
+    Hash256 low, high;
+    high.bytes[0] = 0x80;
+    pair.update(low, sha256(std::string("a")));
+    pair.update(high, sha256(std::string("b")));
+    assert(pair.getRootHash() == sha256(SparseMerkleTree::leafHash(low, sha256(std::string("a"))),
+                                        SparseMerkleTree::leafHash(high, sha256(std::string("b")))));
+
+    Hash256 stateRoot = posChain.getStateRoot();
+    SparseMerkleProof stakeProof = posChain.getStakeProof("V2");
+    assert(SparseMerkleTree::verifyProof(SparseMerkleTree::keyFor("V2"), BlockchainPos::stakeValue(validators[1]), stakeProof, stateRoot));
+    posChain.setValidators({{"V1", 50}, {"V2", 45}});
+    assert(posChain.getStateRoot() != stateRoot);
+    assert(SparseMerkleTree::verifyProof(SparseMerkleTree::keyFor("V3"), Hash256(), posChain.getStakeProof("V3"), posChain.getStateRoot()));
+    posChain.addBlock(txStrings);
+    assert(posChain.isChainValid());
+    std::cout << "PoS Test Passed: Sparse Merkle stake state and proofs.\n";
+
     BlockchainPow powChain(2);
     powChain.addBlock(txStrings);
     powChain.setDifficulty(3);
@@ -6,6 +6,8 @@
 #include <vector>
 #include <iostream>
 #include <cassert>
+#include <chrono>
+#include <thread>
 
 int main() {
     // Partie 1 - Structure des blocs et de la chaîne
@@ -33,6 +35,47 @@ int main() {
     assert(posChain.isChainValid());
     std::cout << "Partie 3 Test Passed: PoS chain is valid.\n";
 
+    // Block hashes cover a stored timestamp, so re-validating later (and
+    // through the base interface) still succeeds.
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    const Blockchain& powBase = powChain;
+    const Blockchain& posBase = posChain;
+    assert(powBase.isChainValid() && posBase.isChainValid());
+    std::string formatted = formatTimestamp(1700000000123LL);
+    assert(formatted.substr(formatted.size() - 4) == ".123");
+    std::cout << "Partie 3 Test Passed: Stored timestamps keep the chains re-verifiable.\n";
+
+    // History proofs: every header commits to the history before it, so a
+    // client holding one header can check that earlier blocks are its
+    // ancestors.
+    std::vector<Hash256> posHashes;
+    BlockchainPos historyChain(2, validators);
+    posHashes.push_back(historyChain.getLatestHash());
+    assert(historyChain.getHeader(0).historyRoot.empty());
+    for (int i = 0; i < 12; i++) {
+        Hash256 before = historyChain.getHistoryRoot();
+        historyChain.addBlock(txStrings);
+        assert(historyChain.getHeader(posHashes.size()).historyRoot == before);
+        posHashes.push_back(historyChain.getLatestHash());
+    }
+    for (uint64_t tip = 1; tip < posHashes.size(); tip++) {
+        const Hash256& committed = historyChain.getHeader(tip).historyRoot;
+        for (uint64_t height = 0; height < tip; height++) {
+            assert(MerkleMountainRange::verifyProof(posHashes[height], historyChain.getAncestryProof(height, tip), committed));
+        }
+        assert(!MerkleMountainRange::verifyProof(posHashes[0], historyChain.getAncestryProof(0), committed));
+    }
+    assert(powChain.getHeader(1).historyRoot == MerkleMountainRange::bagPeaks(1, {powChain.getHeader(0).hash()}));
+    assert(historyChain.isChainValid());
+    Hash256 historyRoot = historyChain.getHistoryRoot();
+    for (size_t height = 0; height < posHashes.size(); height++) {
+        MmrProof proof = historyChain.getAncestryProof(height);
+        assert(proof.siblings.size() <= 4 && proof.peaks.size() <= 4);
+        assert(MerkleMountainRange::verifyProof(posHashes[height], proof, historyRoot));
+        assert(!MerkleMountainRange::verifyProof(posHashes[(height + 1) % posHashes.size()], proof, historyRoot));
+    }
+    std::cout << "Partie 3 Test Passed: Ancestry proofs against the history root.\n";
+
     // Partie 4 - Analyse comparative
     long long powTime = measureTime([&]() { powChain.addBlock(txStrings); });
     long long posTime = measureTime([&]() { posChain.addBlock(txStrings); });